@@ -0,0 +1,151 @@
+#pragma once
+
+// STD
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Test
+#include <Test/Test.hpp>
+
+namespace Bench {
+	/**
+	 * @brief The measurements of a single benchmark.
+	 */
+	struct Result {
+		/** The name of the benchmark. */
+		std::string name;
+
+		/** The number of times the benchmark was run while measuring. */
+		size_t iterations;
+
+		/** The average time of one run in nanoseconds. */
+		double ns_per_op;
+
+		/** The number of input bytes processed per second. Zero if the benchmark has no input. */
+		double bytes_per_second;
+
+		/** The average number of calls to operator new in one run. */
+		double allocations_per_op;
+	};
+
+	/**
+	 * @brief Prevents the compiler from optimizing away the computation of @p value.
+	 * @param[in] value The value to keep.
+	 */
+	template<class T>
+	inline void keep(const T& value) {
+	#if defined(_MSC_VER)
+		static volatile const void* sink;
+		sink = &value;
+	#else
+		asm volatile("" : : "r,m"(value) : "memory");
+	#endif
+	}
+
+	/**
+	 * @brief Runs benchmarks and reports their results.
+	 *
+	 * Each benchmark is run for an increasing number of iterations until a single measurement takes at least
+	 * the minimum time. The results are printed as a table, or as one JSON object per line with --json.
+	 *
+	 * Example usage:
+	 * @code
+	 * Bench::Runner runner{argc, argv};
+	 * runner.run("evaluate/short", equation.size(), [&] { Bench::keep(evaluator.evaluate(equation)); });
+	 * return runner.finish();
+	 * @endcode
+	 */
+	class Runner {
+		public:
+			/**
+			 * @brief Constructs a Runner from the command line arguments.
+			 * Accepts --json, --filter <text> to only run benchmarks whose name contains text,
+			 * and --min-time <ms> to set the minimum measured time of each benchmark.
+			 * @param[in] argc The number of arguments.
+			 * @param[in] argv The arguments.
+			 */
+			Runner(int argc, char* argv[]);
+
+			/**
+			 * @brief Measures @p function and reports the result, unless it is excluded by the filter.
+			 * @param[in] name The name of the benchmark. Groups are separated by '/'.
+			 * @param[in] bytes The number of input bytes processed by one call to @p function.
+			 * @param[in] function The function to measure.
+			 */
+			template<class Function>
+			void run(const std::string& name, size_t bytes, Function function) {
+				if (!selected(name)) { return; }
+
+				// Warm up any caches and lazily allocated memory
+				function();
+
+				size_t iterations = 1;
+
+				while (true) {
+					const auto allocations = Test::allocation_count();
+					const auto start = std::chrono::steady_clock::now();
+
+					for (size_t i = 0; i < iterations; ++i) {
+						function();
+					}
+
+					const auto elapsed = std::chrono::steady_clock::now() - start;
+					const auto allocated = Test::allocation_count() - allocations;
+
+					if (elapsed >= min_time || iterations >= (size_t{1} << 40)) {
+						report(name, bytes, iterations, std::chrono::duration<double, std::nano>(elapsed).count(), allocated);
+						return;
+					}
+
+					// Aim for the minimum time using the rate measured so far
+					const auto nanoseconds = std::max<double>(1.0, std::chrono::duration<double, std::nano>(elapsed).count());
+					const auto target = static_cast<double>(iterations) * std::chrono::duration<double, std::nano>(min_time).count() * 1.2 / nanoseconds;
+					iterations = std::max(iterations * 2, static_cast<size_t>(std::min(target, static_cast<double>(iterations) * 100.0)));
+				}
+			}
+
+			/**
+			 * @brief Get the results reported so far.
+			 * @return The results reported so far.
+			 */
+			const std::vector<Result>& results() const;
+
+			/**
+			 * @brief Finishes reporting.
+			 * @return The exit code of the program.
+			 */
+			int finish();
+
+		private:
+			/** True if the results are printed as JSON */
+			bool json = false;
+
+			/** Only benchmarks whose name contains this are run */
+			std::string filter;
+
+			/** The minimum measured time of each benchmark */
+			std::chrono::nanoseconds min_time = std::chrono::milliseconds{200};
+
+			/** The results reported so far */
+			std::vector<Result> reported;
+
+			/**
+			 * @brief Checks if the benchmark @p name should be run.
+			 * @param[in] name The name of the benchmark.
+			 * @return True if the benchmark should be run, false otherwise.
+			 */
+			bool selected(const std::string& name) const;
+
+			/**
+			 * @brief Records and prints the result of a benchmark.
+			 * @param[in] name The name of the benchmark.
+			 * @param[in] bytes The number of input bytes processed by one run.
+			 * @param[in] iterations The number of runs measured.
+			 * @param[in] nanoseconds The total time of the measured runs.
+			 * @param[in] allocations The total number of allocations of the measured runs.
+			 */
+			void report(const std::string& name, size_t bytes, size_t iterations, double nanoseconds, size_t allocations);
+	};
+}
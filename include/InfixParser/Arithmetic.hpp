@@ -0,0 +1,357 @@
+#pragma once
+
+// STD
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+// InfixParser
+#include <InfixParser/InfixParser.hpp>
+
+/**
+ * @brief Implementations of the arithmetic operators for each value type.
+ *
+ * Integers use exact integer arithmetic. The wrapping functions give the two's complement result when a value does not fit
+ * instead of causing undefined behaviour. The checked functions report when a value does not fit using the compiler's overflow
+ * builtins where they are available. Doubles use IEEE arithmetic and never report overflow.
+ *
+ * The integer functions can be used in constant expressions, which lets eval() share them.
+ */
+namespace InfixParser::Arithmetic {
+	/**
+	 * @brief The unsigned integer type with the same width as @p T.
+	 * std::make_unsigned does not support __int128 in strict standard modes.
+	 */
+	template<class T> struct Unsigned {};
+	template<> struct Unsigned<int> { using type = unsigned; };
+	template<> struct Unsigned<int64_t> { using type = uint64_t; };
+#if defined(INFIXPARSER_INT128)
+	template<> struct Unsigned<__int128> { using type = unsigned __int128; };
+#endif
+
+	/** @brief Get the largest value of the integer type @p T. */
+	template<class T>
+	constexpr T max() {
+		return static_cast<T>(~typename Unsigned<T>::type{0} >> 1);
+	}
+
+	/** @brief Get the smallest value of the integer type @p T. */
+	template<class T>
+	constexpr T min() {
+		return -max<T>() - 1;
+	}
+
+	/**
+	 * @brief Converts the decimal digits [@p begin, @p end) to the integer @p value, the way read_number() and eval() read numbers.
+	 * @return False if the number is too large to be stored in a @p T, true otherwise.
+	 */
+	template<class T>
+	constexpr bool from_digits(const char* begin, const char* end, T& value) {
+		value = 0;
+
+		for (; begin != end; ++begin) {
+			const auto digit = static_cast<T>(*begin - '0');
+
+			if (value > (max<T>() - digit) / 10) {
+				return false;
+			}
+
+			value = value * 10 + digit;
+		}
+
+		return true;
+	}
+
+	/** @brief Get @p left + @p right, wrapping on overflow. */
+	template<class T>
+	constexpr T add(T left, T right) {
+		if constexpr (std::is_floating_point_v<T>) {
+			return left + right;
+		} else {
+			using U = typename Unsigned<T>::type;
+			return static_cast<T>(static_cast<U>(left) + static_cast<U>(right));
+		}
+	}
+
+	/** @brief Get @p left - @p right, wrapping on overflow. */
+	template<class T>
+	constexpr T subtract(T left, T right) {
+		if constexpr (std::is_floating_point_v<T>) {
+			return left - right;
+		} else {
+			using U = typename Unsigned<T>::type;
+			return static_cast<T>(static_cast<U>(left) - static_cast<U>(right));
+		}
+	}
+
+	/** @brief Get @p left * @p right, wrapping on overflow. */
+	template<class T>
+	constexpr T multiply(T left, T right) {
+		if constexpr (std::is_floating_point_v<T>) {
+			return left * right;
+		} else {
+			using U = typename Unsigned<T>::type;
+			return static_cast<T>(static_cast<U>(left) * static_cast<U>(right));
+		}
+	}
+
+	/** @brief Get -@p value, wrapping on overflow. */
+	template<class T>
+	constexpr T negate(T value) {
+		if constexpr (std::is_floating_point_v<T>) {
+			return -value;
+		} else {
+			return subtract(T{0}, value);
+		}
+	}
+
+	/** @brief Get the absolute value of @p value, wrapping on overflow. */
+	template<class T>
+	constexpr T absolute(T value) {
+		if constexpr (std::is_floating_point_v<T>) {
+			return std::fabs(value);
+		} else {
+			return value < 0 ? negate(value) : value;
+		}
+	}
+
+	/** @brief Get the smaller of @p left and @p right. @p left if they are unordered. */
+	template<class T>
+	constexpr T minimum(T left, T right) {
+		return right < left ? right : left;
+	}
+
+	/** @brief Get the larger of @p left and @p right. @p left if they are unordered. */
+	template<class T>
+	constexpr T maximum(T left, T right) {
+		return left < right ? right : left;
+	}
+
+	/** @brief Get @p value limited to [@p low, @p high]. @p high if @p low is larger than @p high. */
+	template<class T>
+	constexpr T clamp(T value, T low, T high) {
+		return minimum(maximum(value, low), high);
+	}
+
+	/**
+	 * @brief Checks if the absolute value of @p value overflows.
+	 * @param[in] value The operand.
+	 * @param[out] result The wrapped result.
+	 * @return True if the result does not fit in a @p T, false otherwise.
+	 */
+	template<class T>
+	constexpr bool absolute_overflow(T value, T& result) {
+		result = absolute(value);
+
+		if constexpr (std::is_floating_point_v<T>) {
+			return false;
+		} else {
+			// The smallest value is the only one without a positive counterpart
+			return value == min<T>();
+		}
+	}
+
+	/**
+	 * @brief Checks if @p left + @p right overflows.
+	 * @param[in] left The left operand.
+	 * @param[in] right The right operand.
+	 * @param[out] result The wrapped result.
+	 * @return True if the result does not fit in a @p T, false otherwise.
+	 */
+	template<class T>
+	constexpr bool add_overflow(T left, T right, T& result) {
+		if constexpr (std::is_floating_point_v<T>) {
+			result = left + right;
+			return false;
+		} else {
+		#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_add_overflow(left, right, &result);
+		#else
+			result = add(left, right);
+			return right > 0 ? left > max<T>() - right : left < min<T>() - right;
+		#endif
+		}
+	}
+
+	/**
+	 * @brief Checks if @p left - @p right overflows.
+	 * @param[in] left The left operand.
+	 * @param[in] right The right operand.
+	 * @param[out] result The wrapped result.
+	 * @return True if the result does not fit in a @p T, false otherwise.
+	 */
+	template<class T>
+	constexpr bool subtract_overflow(T left, T right, T& result) {
+		if constexpr (std::is_floating_point_v<T>) {
+			result = left - right;
+			return false;
+		} else {
+		#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_sub_overflow(left, right, &result);
+		#else
+			result = subtract(left, right);
+			return right < 0 ? left > max<T>() + right : left < min<T>() + right;
+		#endif
+		}
+	}
+
+	/**
+	 * @brief Checks if @p left * @p right overflows.
+	 * @param[in] left The left operand.
+	 * @param[in] right The right operand.
+	 * @param[out] result The wrapped result.
+	 * @return True if the result does not fit in a @p T, false otherwise.
+	 */
+	template<class T>
+	constexpr bool multiply_overflow(T left, T right, T& result) {
+		if constexpr (std::is_floating_point_v<T>) {
+			result = left * right;
+			return false;
+		} else {
+		#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_mul_overflow(left, right, &result);
+		#else
+			result = multiply(left, right);
+
+			if (left == 0 || right == 0) { return false; }
+			if ((left == -1 && right == min<T>()) || (right == -1 && left == min<T>())) { return true; }
+			return result / right != left;
+		#endif
+		}
+	}
+
+	/**
+	 * @brief Get the integer @p base raised to a negative @p exponent, rounded half away from zero.
+	 * Only a magnitude of 1 or 1/2 does not round to zero. @p base must not be zero.
+	 */
+	template<class T>
+	constexpr T negative_power(T base, T exponent) {
+		if (base == 1 || (base == 2 && exponent == -1)) { return 1; }
+		if (base == -1) { return exponent % 2 == 0 ? 1 : -1; }
+		if (base == -2 && exponent == -1) { return -1; }
+		return 0;
+	}
+
+	/**
+	 * @brief Checks if raising @p base to @p exponent divides by zero, which an integer negative power of zero does.
+	 * Doubles follow std::pow instead, where a negative power of zero is infinite.
+	 */
+	template<class T>
+	constexpr bool power_divides_by_zero(T base, T exponent) {
+		return !std::is_floating_point_v<T> && base == 0 && exponent < 0;
+	}
+
+	/**
+	 * @brief Get @p base raised to @p exponent, wrapping on overflow.
+	 * Integers are raised by squaring and negative exponents are rounded half away from zero.
+	 * @p base must not be zero when @p exponent is negative.
+	 */
+	template<class T>
+	constexpr T power(T base, T exponent) {
+		if constexpr (std::is_floating_point_v<T>) {
+			return std::pow(base, exponent);
+		} else {
+			if (exponent < 0) { return negative_power(base, exponent); }
+
+			using U = typename Unsigned<T>::type;
+			auto result = U{1};
+			auto square = static_cast<U>(base);
+
+			for (auto remaining = static_cast<U>(exponent); remaining != 0; remaining >>= 1) {
+				if (remaining & 1) { result *= square; }
+				square *= square;
+			}
+
+			return static_cast<T>(result);
+		}
+	}
+
+	/**
+	 * @brief Checks if @p base raised to @p exponent overflows.
+	 * Integers are raised by squaring and negative exponents are rounded half away from zero.
+	 * @p base must not be zero when @p exponent is negative.
+	 * @param[in] base The base.
+	 * @param[in] exponent The exponent.
+	 * @param[out] result The result. Unspecified if the result does not fit in a @p T.
+	 * @return True if the result does not fit in a @p T, false otherwise.
+	 */
+	template<class T>
+	constexpr bool power_overflow(T base, T exponent, T& result) {
+		if constexpr (std::is_floating_point_v<T>) {
+			result = std::pow(base, exponent);
+			return false;
+		} else {
+			if (exponent < 0) {
+				result = negative_power(base, exponent);
+				return false;
+			}
+
+			result = 1;
+
+			while (true) {
+				if ((exponent & 1) && multiply_overflow(result, base, result)) { return true; }
+
+				exponent >>= 1;
+				if (exponent == 0) { return false; }
+
+				// The square is always needed by a later bit, so it overflowing means the result does too
+				if (multiply_overflow(base, base, base)) { return true; }
+			}
+		}
+	}
+
+	/**
+	 * @brief Get @p left / @p right. @p right must not be zero.
+	 * Integer quotients are rounded half away from zero, the same as rounding the exact quotient, and the smallest value / -1 wraps.
+	 */
+	template<class T>
+	constexpr T divide(T left, T right) {
+		if constexpr (std::is_floating_point_v<T>) {
+			return left / right;
+		} else {
+			if (right == -1) { return negate(left); }
+
+			using U = typename Unsigned<T>::type;
+			const auto quotient = left / right;
+			const auto remainder = left % right;
+
+			// Compare twice the remainder with the divisor without overflowing
+			const auto twice = U{2} * (remainder < 0 ? U{0} - static_cast<U>(remainder) : static_cast<U>(remainder));
+			const auto divisor = right < 0 ? U{0} - static_cast<U>(right) : static_cast<U>(right);
+
+			if (twice < divisor) { return quotient; }
+			return (left < 0) == (right < 0) ? quotient + 1 : quotient - 1;
+		}
+	}
+
+	/**
+	 * @brief Checks if @p left / @p right overflows. @p right must not be zero.
+	 * @param[in] left The left operand.
+	 * @param[in] right The right operand.
+	 * @param[out] result The result. Unspecified if the result does not fit in a @p T.
+	 * @return True if the result does not fit in a @p T, false otherwise.
+	 */
+	template<class T>
+	constexpr bool divide_overflow(T left, T right, T& result) {
+		if constexpr (!std::is_floating_point_v<T>) {
+			// The smallest value / -1 is the only quotient that does not fit
+			if (right == -1 && left == min<T>()) { return true; }
+		}
+
+		result = divide(left, right);
+		return false;
+	}
+
+	/**
+	 * @brief Get the remainder of @p left / @p right truncated towards zero. @p right must not be zero.
+	 */
+	template<class T>
+	constexpr T remainder(T left, T right) {
+		if constexpr (std::is_floating_point_v<T>) {
+			return std::fmod(left, right);
+		} else {
+			// The smallest value % -1 is undefined even though the remainder is zero
+			return right == -1 ? 0 : left % right;
+		}
+	}
+}
@@ -0,0 +1,438 @@
+#pragma once
+
+// STD
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// InfixParser
+#include <InfixParser/Operator.hpp>
+#include <InfixParser/Kernels.hpp>
+#include <InfixParser/Error.hpp>
+
+namespace InfixParser {
+	template<class T>
+	class BasicEvaluator;
+
+	template<class T>
+	class BasicExpressionPack;
+
+	/**
+	 * @brief A single step of a CompiledExpression.
+	 * @tparam T The type of the values. One of int, int64_t, __int128 or double.
+	 */
+	template<class T>
+	struct BasicInstruction {
+		/** The kinds of instructions. */
+		enum class Type {
+			/** Pushes #value onto the operand stack. */
+			VALUE,
+
+			/** Pushes the bound value of the variable in slot #value onto the operand stack. */
+			VARIABLE,
+
+			/** Applies #op to the operand stack. */
+			OPERATOR,
+
+			/**
+			 * Skips the next #value instructions when the top operand is false (zero), leaving it as the result.
+			 * Emitted after the left side of && so its right side only runs when needed.
+			 */
+			JUMP_IF_FALSE,
+
+			/**
+			 * Replaces the top operand with 1 and skips the next #value instructions when it is true (non-zero).
+			 * Emitted after the left side of || so its right side only runs when needed.
+			 */
+			JUMP_IF_TRUE,
+		};
+
+		/** The kind of this instruction. */
+		Type type;
+
+		/** The Operator to apply. Only used by Type::OPERATOR instructions. */
+		const BasicOperator<T>* op;
+
+		/** The value or variable slot to push, or the number of instructions to skip for jumps. Unused by Type::OPERATOR instructions. */
+		T value;
+
+		/** The position in the source equation this instruction was produced from. Used only for error reporting. */
+		size_t position;
+	};
+
+	/** A single step of a CompiledExpression. */
+	using Instruction = BasicInstruction<int>;
+
+	/**
+	 * @brief An immutable postfix program produced by Evaluator::compile.
+	 * Running a CompiledExpression does no tokenizing or operator precedence work.
+	 *
+	 * Example usage:
+	 * @code
+	 * Evaluator evaluator;
+	 * const auto expression = evaluator.compile("(1+2)*3");
+	 * auto result = expression.run();
+	 * @endcode
+	 *
+	 * Variables are resolved to slots when compiling. Their values are bound per run as a flat array:
+	 * @code
+	 * const auto expression = evaluator.compile("price * quantity > limit");
+	 * const int values[] = {25, 4, 90}; // In the order of expression.variables()
+	 * auto result = expression.run(values);
+	 * @endcode
+	 *
+	 * The right side of && is only run when its left side is true and the right side of || only when its left side is false.
+	 * Errors such as division by zero in a side that is not run are never reported:
+	 * @code
+	 * const auto guard = evaluator.compile("count != 0 && total / count > 10");
+	 * @endcode
+	 *
+	 * Many rows can be evaluated at once from column arrays using run_batch():
+	 * @code
+	 * const int* columns[] = {prices, quantities, limits}; // In the order of expression.variables()
+	 * expression.run_batch(columns, results, rows);
+	 * @endcode
+	 *
+	 * Boolean expressions can instead select the rows they are true for using filter():
+	 * @code
+	 * std::vector<size_t> selection;
+	 * expression.filter(columns, rows, selection);
+	 * @endcode
+	 *
+	 * Only expressions of ints run the vectorized kernels in InfixParser::Kernels. Other value types apply their operators one row at a time.
+	 *
+	 * @tparam T The type of the values. One of int, int64_t, __int128 or double.
+	 */
+	template<class T>
+	class BasicCompiledExpression {
+		friend class BasicEvaluator<T>;
+		friend class BasicExpressionPack<T>;
+
+		public:
+			/**
+			 * @brief Runs this expression and returns the result.
+			 * @throws EvaluationException When an Operator fails to apply.
+			 */
+			T run() const;
+
+			/**
+			 * @brief Runs this expression using @p operands as scratch space and returns the result.
+			 * @param[in,out] operands The operand stack to use. Any existing contents are discarded.
+			 * @throws EvaluationException When an Operator fails to apply.
+			 */
+			T run(BasicOperandStack<T>& operands) const;
+
+			/**
+			 * @brief Runs this expression with the variable values @p values and returns the result.
+			 * @param[in] values The value of each variable, indexed by slot. See variables().
+			 * @throws EvaluationException When an Operator fails to apply.
+			 */
+			T run(const T* values) const;
+
+			/**
+			 * @brief Runs this expression with the variable values @p values using @p operands as scratch space and returns the result.
+			 * @param[in] values The value of each variable, indexed by slot. See variables().
+			 * @param[in,out] operands The operand stack to use. Any existing contents are discarded.
+			 * @throws EvaluationException When an Operator fails to apply.
+			 */
+			T run(const T* values, BasicOperandStack<T>& operands) const;
+
+			/**
+			 * @brief Runs this expression with the variable values @p values without throwing.
+			 * @param[in] values The value of each variable, indexed by slot. See variables().
+			 * @param[in,out] operands The operand stack to use. Any existing contents are discarded.
+			 * @return The result, or the error and the position of the Operator that failed to apply.
+			 */
+			BasicEvaluationResult<T> try_run(const T* values, BasicOperandStack<T>& operands) const;
+
+			/**
+			 * @brief Runs this expression once for each of @p rows rows and stores the results in @p results.
+			 * Operators are applied to blocks of rows at a time using the vectorized kernels in InfixParser::Kernels.
+			 *
+			 * @param[in] columns The values of each variable, indexed by slot. Each column must contain @p rows values. See variables().
+			 * @param[out] results The array to store the results in. Must contain space for @p rows values.
+			 * @param[in] rows The number of rows to evaluate.
+			 * @throws EvaluationException When an Operator fails to apply to a row.
+			 */
+			void run_batch(const T* const* columns, T* results, size_t rows) const;
+
+			/**
+			 * @brief Finds the rows this expression is true (non-zero) for.
+			 * The right side of an AND is only run for rows that pass its left side,
+			 * and the right side of an OR only for rows that fail its left side.
+			 * Errors such as division by zero are not reported for rows a side is skipped for.
+			 *
+			 * @param[in] columns The values of each variable, indexed by slot. Each column must contain @p rows values. See variables().
+			 * @param[in] rows The number of rows to evaluate.
+			 * @param[out] selection The indices of the rows this expression is true for, in ascending order.
+			 * @throws EvaluationException When an Operator fails to apply to a row.
+			 */
+			void filter(const T* const* columns, size_t rows, std::vector<size_t>& selection) const;
+
+			/**
+			 * @brief Finds the rows this expression is true (non-zero) for.
+			 * Behaves the same as filter() but stores the result as a packed bitmap.
+			 *
+			 * @param[in] columns The values of each variable, indexed by slot. Each column must contain @p rows values. See variables().
+			 * @param[in] rows The number of rows to evaluate.
+			 * @param[out] bitmap Bit (i % 64) of bitmap[i / 64] is set if this expression is true for row i.
+			 * @throws EvaluationException When an Operator fails to apply to a row.
+			 */
+			void filter_bitmap(const T* const* columns, size_t rows, std::vector<uint64_t>& bitmap) const;
+
+			/**
+			 * @brief Get the equation this expression was compiled from.
+			 * @return The equation this expression was compiled from.
+			 */
+			const std::string& equation() const;
+
+			/**
+			 * @brief Get the instructions of this expression in postfix order.
+			 * @return The instructions of this expression.
+			 */
+			const std::vector<BasicInstruction<T>>& instructions() const;
+
+			/**
+			 * @brief Get the names of the variables used by this expression.
+			 * The index of a name is the slot its value is read from when running.
+			 * @return The names of the variables used by this expression.
+			 */
+			const std::vector<std::string>& variables() const;
+
+			/**
+			 * @brief Get the maximum number of operands on the stack while running this expression.
+			 * @return The maximum number of operands on the stack.
+			 */
+			size_t max_depth() const;
+
+			/**
+			 * @brief Runs the instructions [@p begin, @p end) and returns the result without throwing.
+			 * The instructions must form a valid program such as those produced by Evaluator::compile.
+			 *
+			 * @param[in] begin The first instruction to run.
+			 * @param[in] end One past the last instruction to run.
+			 * @param[in] values The value of each variable, indexed by slot. May be nullptr if there are no variables.
+			 * @param[in,out] operands The operand stack to use. Any existing contents are discarded.
+			 * @return The result, or the error and the position of the Operator that failed to apply.
+			 */
+			static BasicEvaluationResult<T> execute(const BasicInstruction<T>* begin, const BasicInstruction<T>* end, const T* values, BasicOperandStack<T>& operands);
+
+			/**
+			 * @brief Runs the instructions [@p begin, @p end) like execute(), calling @p applying with each Operator before it is applied.
+			 * Operators skipped by && and || are not passed to @p applying.
+			 *
+			 * @param[in] begin The first instruction to run.
+			 * @param[in] end One past the last instruction to run.
+			 * @param[in] values The value of each variable, indexed by slot. May be nullptr if there are no variables.
+			 * @param[in,out] operands The operand stack to use. Any existing contents are discarded.
+			 * @param[in] applying Called as applying(op) with the `const BasicOperator<T>&` about to be applied.
+			 * @return The result, or the error and the position of the Operator that failed to apply.
+			 */
+			template<class Applying>
+			static BasicEvaluationResult<T> execute(const BasicInstruction<T>* begin, const BasicInstruction<T>* end, const T* values, BasicOperandStack<T>& operands, Applying&& applying);
+
+		private:
+			/** The types used with values of type T */
+			using Instruction = BasicInstruction<T>;
+			using Operator = BasicOperator<T>;
+			using OperandStack = BasicOperandStack<T>;
+			using EvaluationResult = BasicEvaluationResult<T>;
+
+			/** The equation this expression was compiled from */
+			std::string source;
+
+			/** The instructions in postfix order */
+			std::vector<BasicInstruction<T>> program;
+
+			/** The variable names indexed by slot */
+			std::vector<std::string> names;
+
+			/** The maximum number of operands on the stack */
+			size_t depth;
+
+			/**
+			 * The operations run by interpret(). Each corresponds to an Instruction type or one of the predefined Operators.
+			 * Code::APPLY stands for any other Operator and makes interpret() stop so the program is run by execute() instead.
+			 */
+			enum class Code : uint8_t {
+				VALUE, VARIABLE, JUMP_IF_FALSE, JUMP_IF_TRUE,
+				NEGATE, NOT, PRE_INCREMENT, PRE_DECREMENT,
+				POWER, MULTIPLY, DIVIDE, REMAINDER, ADD, SUBTRACT,
+				GREATER, GREATER_OR_EQUAL, LESS, LESS_OR_EQUAL, EQUAL, NOT_EQUAL, AND, OR,
+				ABS, MIN, MAX, CLAMP,
+				CHECKED_NEGATE, CHECKED_PRE_INCREMENT, CHECKED_PRE_DECREMENT,
+				CHECKED_POWER, CHECKED_MULTIPLY, CHECKED_DIVIDE, CHECKED_ADD, CHECKED_SUBTRACT, CHECKED_ABS,
+				APPLY, END,
+			};
+
+			/** A single step of the dense program run by interpret() */
+			struct Operation {
+				/** The operation to run */
+				Code code;
+
+				/** The value or variable slot to push, or the number of operations to skip for jumps */
+				T value;
+			};
+
+			/** The operations run by interpret(), one for each instruction followed by Code::END */
+			std::vector<Operation> code;
+
+			/** The number of rows run_batch() evaluates at a time */
+			static constexpr size_t block_size = 256;
+
+			/**
+			 * @brief The rows in a block.
+			 */
+			struct Rows {
+				/** The indices of the rows. If nullptr the rows are [#offset, #offset + #count). */
+				const size_t* selection;
+
+				/** The index of the first row. Only used when #selection is nullptr. */
+				size_t offset;
+
+				/** The number of rows. At most block_size. */
+				size_t count;
+			};
+
+			/**
+			 * @brief Finds the kernel for each instruction.
+			 * @return The kernel for each instruction, indexed the same as #program.
+			 */
+			std::vector<Kernels::Kernel> find_kernels() const;
+
+			/**
+			 * @brief Finds the first instruction of the operand that ends just before @p end.
+			 * @param[in] end One past the last instruction of the operand.
+			 * @return The index of the first instruction of the operand.
+			 */
+			size_t operand_begin(size_t end) const;
+
+			/**
+			 * @brief Finds the end of the left operand of the binary operator whose right operand starts at @p right.
+			 * @param[in] right The index of the first instruction of the right operand.
+			 * @return One past the last instruction of the left operand, excluding the jump between the operands of && and ||.
+			 */
+			size_t left_end(size_t right) const;
+
+			/**
+			 * @brief Runs the instructions [@p begin, @p end) for a block of rows. The result is stored in the first block of @p stack.
+			 * @param[in] begin The index of the first instruction to run.
+			 * @param[in] end One past the index of the last instruction to run.
+			 * @param[in] kernels The kernel for each instruction. See find_kernels().
+			 * @param[in] columns The values of each variable, indexed by slot.
+			 * @param[in] rows The rows to run the instructions for.
+			 * @param[out] stack Space for max_depth() blocks of block_size values.
+			 * @param[out] selections Space for block_size row indices for each jump in #program, reused by every block.
+			 * @throws EvaluationException When an Operator fails to apply to a row.
+			 */
+			void run_block(size_t begin, size_t end, const Kernels::Kernel* kernels, const T* const* columns, const Rows& rows, T* stack, size_t* selections) const;
+
+			/**
+			 * @brief Partitions @p selection into the rows the instructions [@p begin, @p end) are true (non-zero) for, followed by the rows they are false for.
+			 * Both parts stay in ascending order.
+			 *
+			 * @param[in] begin The index of the first instruction to run.
+			 * @param[in] end One past the index of the last instruction to run.
+			 * @param[in] kernels The kernel for each instruction. See find_kernels().
+			 * @param[in] columns The values of each variable, indexed by slot.
+			 * @param[in,out] selection The indices of the rows to check, in ascending order.
+			 * @param[in] count The number of rows in @p selection. At most block_size.
+			 * @param[out] scratch Space for block_size indices, and at least block_size indices for each jump in #program.
+			 * @param[out] stack Space for max_depth() blocks of block_size values.
+			 * @return The number of rows the instructions are true for.
+			 * @throws EvaluationException When an Operator fails to apply to a row.
+			 */
+			size_t filter_range(size_t begin, size_t end, const Kernels::Kernel* kernels, const T* const* columns, size_t* selection, size_t count, size_t* scratch, T* stack) const;
+
+			/**
+			 * @brief Applies the Operator of @p instruction to the rows [@p begin, @p rows.count) of a block one row at a time.
+			 * The operands of the Operator are stored in consecutive blocks of block_size values starting at @p operands.
+			 *
+			 * @param[in] instruction The Type::OPERATOR instruction to apply.
+			 * @param[in,out] operands The first block of operands. Overwritten with the results.
+			 * @param[in] begin The first row in the block to apply the Operator to.
+			 * @param[in] rows The rows in the block. Used only for error reporting.
+			 * @throws EvaluationException When the Operator fails to apply to a row.
+			 */
+			void apply_rows(const BasicInstruction<T>& instruction, T* operands, size_t begin, const Rows& rows) const;
+
+			/**
+			 * @brief Translates @p instruction into the Operation interpret() runs for it.
+			 * @param[in] instruction The instruction to translate.
+			 * @return The Operation for @p instruction.
+			 */
+			static Operation encode(const BasicInstruction<T>& instruction);
+
+			/**
+			 * @brief Runs the operations starting at @p first with the operands kept in a flat array.
+			 * Dispatches directly from each operation to the next using computed goto where the compiler supports it.
+			 *
+			 * @param[in] first The first operation. The operations must end with Code::END.
+			 * @param[in] values The value of each variable, indexed by slot.
+			 * @param[out] stack Space for max_depth() values. The result is stored in the first value.
+			 * @return The index of Code::END on success, otherwise the index of the instruction that could not be run.
+			 */
+			static size_t interpret(const Operation* first, const T* values, T* stack);
+
+			/**
+			 * @brief Constructs a compiled expression.
+			 * @param[in] source The equation the expression was compiled from.
+			 * @param[in] program The instructions in postfix order.
+			 * @param[in] names The variable names indexed by slot.
+			 * @param[in] depth The maximum number of operands on the stack.
+			 */
+			BasicCompiledExpression(std::string source, std::vector<BasicInstruction<T>> program, std::vector<std::string> names, size_t depth);
+	};
+
+	template<class T>
+	template<class Applying>
+	BasicEvaluationResult<T> BasicCompiledExpression<T>::execute(const BasicInstruction<T>* begin, const BasicInstruction<T>* end, const T* values, BasicOperandStack<T>& operands, Applying&& applying) {
+		// Ensure our stack is empty without releasing any memory
+		operands.clear();
+
+		// Run the program
+		for (auto current = begin; current != end; ++current) {
+			switch (current->type) {
+				case Instruction::Type::VALUE:
+					operands.push(current->value);
+					break;
+				case Instruction::Type::VARIABLE:
+					operands.push(values[static_cast<size_t>(current->value)]);
+					break;
+				case Instruction::Type::JUMP_IF_FALSE:
+					if (operands.top() == 0) { current += static_cast<ptrdiff_t>(current->value); }
+					break;
+				case Instruction::Type::JUMP_IF_TRUE:
+					if (operands.top() != 0) {
+						operands.top() = 1;
+						current += static_cast<ptrdiff_t>(current->value);
+					}
+
+					break;
+				case Instruction::Type::OPERATOR:
+					applying(*current->op);
+
+					if (const auto error = current->op->apply(operands); error != Error::NONE) {
+						return {0, error, current->position, current->op};
+					}
+
+					break;
+			}
+		}
+
+		// Get the result
+		return {operands.top()};
+	}
+
+	/** An immutable postfix program of ints produced by Evaluator::compile. */
+	using CompiledExpression = BasicCompiledExpression<int>;
+
+	extern template class BasicCompiledExpression<int>;
+	extern template class BasicCompiledExpression<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	extern template class BasicCompiledExpression<__int128>;
+#endif
+	extern template class BasicCompiledExpression<double>;
+}
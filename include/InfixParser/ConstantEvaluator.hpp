@@ -0,0 +1,476 @@
+#pragma once
+
+// STD
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+// InfixParser
+#include <InfixParser/Arithmetic.hpp>
+#include <InfixParser/Error.hpp>
+#include <InfixParser/Operator.hpp>
+#include <InfixParser/CompiledExpression.hpp>
+#include <InfixParser/Evaluator.hpp>
+#include <InfixParser/ShuntingYard.hpp>
+
+namespace InfixParser {
+	/**
+	 * @brief Reports the error eval() found in @p equation.
+	 * Not constexpr, so an ill formed equation evaluated at compile time is a compile error that names @p error.
+	 * At runtime the equation is handed to BasicEvaluator::evaluate so the exception is the one it would throw.
+	 * @param[in] equation The equation that could not be evaluated.
+	 * @param[in] error Why the equation could not be evaluated.
+	 * @throws EvaluationException Always.
+	 */
+	template<class T>
+	[[noreturn]] void throw_constant_error(std::string_view equation, Error error) {
+		BasicEvaluator<T>{}.evaluate(equation);
+		throw EvaluationException{to_string(error)};
+	}
+
+	/**
+	 * @brief A stack of at most @p N values that can be used in constant expressions, where a Stack cannot allocate.
+	 * @tparam T The type of the values. Must be default constructible.
+	 * @tparam N The capacity of the stack.
+	 */
+	template<class T, size_t N>
+	class FixedStack {
+		public:
+			/** @brief Adds @p value to the top of this stack. This stack must not be full. */
+			constexpr void push(const T& value) {
+				values[count++] = value;
+			}
+
+			/** @brief Removes the top value of this stack. This stack must not be empty. */
+			constexpr void pop() {
+				--count;
+			}
+
+			/** @brief Get the top value of this stack. This stack must not be empty. */
+			constexpr T& top() {
+				return values[count - 1];
+			}
+
+			/** @brief Get the number of values in this stack. */
+			constexpr size_t size() const {
+				return count;
+			}
+
+			/** @brief Checks if this stack is empty. */
+			constexpr bool empty() const {
+				return count == 0;
+			}
+
+			/** @brief Removes every value from this stack. */
+			constexpr void clear() {
+				count = 0;
+			}
+
+			/** @brief Get the values of this stack from the bottom to the top. */
+			constexpr T* data() {
+				return values;
+			}
+
+		private:
+			/** The values */
+			T values[N] = {};
+
+			/** The number of values in the stack */
+			size_t count = 0;
+	};
+
+	/**
+	 * @brief Evaluates an infix equation in a constant expression.
+	 *
+	 * Converts equations with the same ShuntingYard, lexer and grammar as an Evaluator of the predefined operators, and applies them
+	 * with the same Arithmetic, so an equation has the same value or error whether it is evaluated by the compiler or at runtime.
+	 * Only running the instructions is separate: the runtime operators are applied through function pointers, which cannot be
+	 * called in constant expressions. Operators added to a BasicOperatorRegistry are only known at runtime, so they cannot be used.
+	 * Constant expressions cannot allocate, so the program and the stacks hold @p N elements. No character adds more than one
+	 * element to any of them.
+	 *
+	 * Use eval() rather than constructing one directly.
+	 *
+	 * @tparam T The type of the value. One of int, int64_t or __int128.
+	 * @tparam N The capacity of the program and each stack. Must be larger than the length of the equations.
+	 */
+	template<class T, size_t N>
+	class ConstantEvaluator : private ShuntingYard<ConstantEvaluator<T, N>, T, OperatorKind, FixedStack, N> {
+		static_assert(!std::is_floating_point_v<T>, "std::pow and std::fmod cannot be used in constant expressions");
+
+		public:
+			/**
+			 * @brief Evaluates the equation @p equation and returns the result.
+			 * @param[in] equation The equation to evaluate. Must have fewer than @p N characters.
+			 * @return The value of @p equation.
+			 * @throws EvaluationException When @p equation is ill formed or fails to evaluate. A compile error in a constant expression.
+			 */
+			constexpr T evaluate(std::string_view equation) {
+				const auto result = try_evaluate(equation);
+
+				if (result.error != Error::NONE) {
+					throw_constant_error<T>(equation, result.error);
+				}
+
+				return result.value;
+			}
+
+			/**
+			 * @brief Evaluates the equation @p equation without throwing.
+			 * @param[in] equation The equation to evaluate. Must have fewer than @p N characters.
+			 * @return The value of @p equation, or the error that prevented it from being evaluated and where it occurred.
+			 *         The Operator of an error is never set, since the grammar of an operator is not an Operator.
+			 */
+			constexpr BasicEvaluationResult<T> try_evaluate(std::string_view equation) {
+				if (const auto error = build(equation); error != Error::NONE) {
+					return {0, error, error_position, nullptr};
+				}
+
+				return execute();
+			}
+
+		private:
+			/** Converts equations with the shunting-yard algorithm shared with BasicEvaluator */
+			using ShuntingYard = InfixParser::ShuntingYard<ConstantEvaluator<T, N>, T, OperatorKind, FixedStack, N>;
+			friend ShuntingYard;
+
+			using typename ShuntingYard::Type;
+			using ShuntingYard::position;
+			using ShuntingYard::error_position;
+			using ShuntingYard::no_jump;
+			using ShuntingYard::build;
+
+			/**
+			 * No operator. eval() cannot use registered operators, so their kind is free to mark the absence of one.
+			 * Operators are identified by their kind rather than the address of their Grammar, which some compilers do not
+			 * treat as constant when sanitizers are enabled.
+			 */
+			static constexpr auto none = OperatorKind::REGISTERED;
+
+			/** A postfix instruction. The same as BasicInstruction, with the kind of the operator instead of the runtime Operator. */
+			struct Instruction {
+				Type type = Type::VALUE;
+				OperatorKind op = none;
+				T value = 0;
+				size_t position = 0;
+			};
+
+			/** A symbol of the predefined registry, see BasicOperatorRegistry::BasicOperatorRegistry */
+			struct Symbol {
+				/** The characters of the symbol */
+				std::string_view text;
+
+				/** The operator used after an operand */
+				OperatorKind infix;
+
+				/** The operator used where an operand is expected */
+				OperatorKind prefix;
+			};
+
+			/** The symbols of the predefined operators */
+			static constexpr Symbol symbols[] = {
+				{"-", OperatorKind::SUBTRACT, OperatorKind::NEGATE},
+				{")", OperatorKind::RIGHT_PAREN, none},
+				{"!", none, OperatorKind::NOT},
+				{"++", none, OperatorKind::PRE_INCREMENT},
+				{"--", none, OperatorKind::PRE_DECREMENT},
+				{"^", OperatorKind::POWER, none},
+				{"*", OperatorKind::MULTIPLY, none},
+				{"/", OperatorKind::DIVIDE, none},
+				{"%", OperatorKind::REMAINDER, none},
+				{"+", OperatorKind::ADD, none},
+				{">", OperatorKind::GREATER, none},
+				{">=", OperatorKind::GREATER_OR_EQUAL, none},
+				{"<", OperatorKind::LESS, none},
+				{"<=", OperatorKind::LESS_OR_EQUAL, none},
+				{"==", OperatorKind::EQUAL, none},
+				{"!=", OperatorKind::NOT_EQUAL, none},
+				{"&&", OperatorKind::AND, none},
+				{"||", OperatorKind::OR, none},
+				{"(", none, OperatorKind::LEFT_PAREN},
+				{",", OperatorKind::COMMA, none},
+			};
+
+			/** The built-in functions, called by the token of their grammar */
+			static constexpr OperatorKind functions[] = {OperatorKind::ABS, OperatorKind::MIN, OperatorKind::MAX, OperatorKind::CLAMP};
+
+			/** Stores the instructions emitted so far */
+			FixedStack<Instruction, N> program;
+
+			/** Stores all active operands while the program runs */
+			T operands[N] = {};
+
+			/**
+			 * @brief Get the grammar of @p op.
+			 * @param[in] op The operator. Must not be #none.
+			 * @return The grammar of @p op, shared with the runtime Operator.
+			 */
+			static constexpr const OperatorInfo& grammar(OperatorKind op) {
+				switch (op) {
+					case OperatorKind::ABS: return Grammar::ABS;
+					case OperatorKind::MIN: return Grammar::MIN;
+					case OperatorKind::MAX: return Grammar::MAX;
+					case OperatorKind::CLAMP: return Grammar::CLAMP;
+					case OperatorKind::NEGATE: return Grammar::NEGATE;
+					case OperatorKind::RIGHT_PAREN: return Grammar::RIGHT_PAREN;
+					case OperatorKind::NOT: return Grammar::NOT;
+					case OperatorKind::PRE_INCREMENT: return Grammar::PRE_INCREMENT;
+					case OperatorKind::PRE_DECREMENT: return Grammar::PRE_DECREMENT;
+					case OperatorKind::POWER: return Grammar::POWER;
+					case OperatorKind::MULTIPLY: return Grammar::MULTIPLY;
+					case OperatorKind::DIVIDE: return Grammar::DIVIDE;
+					case OperatorKind::REMAINDER: return Grammar::REMAINDER;
+					case OperatorKind::ADD: return Grammar::ADD;
+					case OperatorKind::SUBTRACT: return Grammar::SUBTRACT;
+					case OperatorKind::GREATER: return Grammar::GREATER;
+					case OperatorKind::GREATER_OR_EQUAL: return Grammar::GREATER_OR_EQUAL;
+					case OperatorKind::LESS: return Grammar::LESS;
+					case OperatorKind::LESS_OR_EQUAL: return Grammar::LESS_OR_EQUAL;
+					case OperatorKind::EQUAL: return Grammar::EQUAL;
+					case OperatorKind::NOT_EQUAL: return Grammar::NOT_EQUAL;
+					case OperatorKind::AND: return Grammar::AND;
+					case OperatorKind::OR: return Grammar::OR;
+					case OperatorKind::COMMA: return Grammar::COMMA;
+					case OperatorKind::REGISTERED:
+					case OperatorKind::LEFT_PAREN: break;
+				}
+
+				return Grammar::LEFT_PAREN;
+			}
+
+			/** @brief Get the kind of @p op. */
+			static constexpr OperatorKind kind(OperatorKind op) {
+				return op;
+			}
+
+			/** @brief Get the precedence of @p op. */
+			static constexpr int precedence(OperatorKind op) {
+				return grammar(op).precedence;
+			}
+
+			/** @brief Checks if @p op is right associative. */
+			static constexpr bool is_right_associative(OperatorKind op) {
+				return grammar(op).right_associative;
+			}
+
+			/** @brief Get the number of operands @p op consumes. */
+			static constexpr int arity(OperatorKind op) {
+				return grammar(op).arity;
+			}
+
+			/** @brief Finds the end of the whitespace at @p begin, the same as InfixParser::skip_whitespace. */
+			static constexpr const char* skip_whitespace(const char* begin, const char* end) {
+				while (begin != end && is_whitespace(*begin)) { ++begin; }
+				return begin;
+			}
+
+			/** @brief Reads the number at @p begin, the same as InfixParser::read_number. */
+			static constexpr bool read_number(const char*& begin, const char* end, T& value) {
+				auto number_end = begin;
+				while (number_end != end && is_number(*number_end)) { ++number_end; }
+
+				const auto fits = Arithmetic::from_digits(begin, number_end, value);
+				begin = number_end;
+				return fits;
+			}
+
+			/**
+			 * @brief Reads the longest symbol at @p begin, the same as BasicOperatorRegistry::match does for the predefined registry.
+			 * @param[in,out] begin The start of the symbol. Moved past the symbol, or by one character when no symbol matches.
+			 * @param[in] end The end of the string to read from.
+			 * @param[in] prefix True if an operand is expected, so the prefix operator of the symbol is preferred.
+			 * @return The operator. #none if no symbol matches.
+			 */
+			constexpr OperatorKind match(const char*& begin, const char* end, bool prefix) const {
+				const auto available = std::string_view{begin, static_cast<size_t>(end - begin)};
+				size_t length = 0;
+				auto infix = none;
+				auto prefixed = none;
+
+				for (const auto& symbol : symbols) {
+					if (symbol.text.size() > length && available.substr(0, symbol.text.size()) == symbol.text) {
+						length = symbol.text.size();
+						infix = symbol.infix;
+						prefixed = symbol.prefix;
+					}
+				}
+
+				begin += length == 0 ? 1 : length;
+
+				// A symbol with only one operator uses it in both places
+				const auto preferred = prefix ? prefixed : infix;
+				return preferred != none ? preferred : (prefix ? infix : prefixed);
+			}
+
+			/**
+			 * @brief Get the built-in function called @p name.
+			 * @return The function. #none if there is no built-in function called @p name.
+			 */
+			constexpr OperatorKind find_function(std::string_view name) const {
+				for (const auto function : functions) {
+					if (name == grammar(function).token) { return function; }
+				}
+
+				return none;
+			}
+
+			/**
+			 * @brief Equations evaluated without compiling cannot have variables.
+			 * @return False.
+			 */
+			constexpr bool resolve(std::string_view, int&) const {
+				return false;
+			}
+
+			/** @brief Empties #program before an equation is converted. */
+			constexpr void begin_program() {
+				program.clear();
+			}
+
+			/** @brief Appends an instruction that pushes an operand to #program. */
+			constexpr void emit_operand(Type type, T value) {
+				program.push({type, none, value, position});
+			}
+
+			/** @brief Appends an instruction that applies @p op to #program, completing the jump that skips to it, if any. */
+			constexpr void emit_operator(OperatorKind op, size_t, size_t jump) {
+				program.push({Type::OPERATOR, op, 0, position});
+
+				if (jump != no_jump) {
+					program.data()[jump].value = static_cast<T>(program.size() - jump - 1);
+				}
+			}
+
+			/**
+			 * @brief Appends the jump that skips the right side of && or || to #program.
+			 * @return The index of the jump.
+			 */
+			constexpr size_t emit_jump(Type type) {
+				program.push({type, none, 0, position});
+				return program.size() - 1;
+			}
+
+			/** @brief Statistics are not counted in constant expressions. */
+			constexpr void lexed_token() {}
+
+			/** @brief Statistics are not counted in constant expressions. */
+			constexpr void pushed_operator() {}
+
+			/**
+			 * @brief Runs #program, the same way BasicCompiledExpression::execute does.
+			 * @return The result, or the error and the position of the operator that failed to apply.
+			 */
+			constexpr BasicEvaluationResult<T> execute() {
+				size_t top = 0;
+
+				for (size_t current = 0; current < program.size(); ++current) {
+					const auto& instruction = program.data()[current];
+
+					switch (instruction.type) {
+						case Type::VALUE:
+						case Type::VARIABLE:
+							operands[top++] = instruction.value;
+							break;
+						case Type::JUMP_IF_FALSE:
+							if (operands[top - 1] == 0) { current += static_cast<size_t>(instruction.value); }
+							break;
+						case Type::JUMP_IF_TRUE:
+							if (operands[top - 1] != 0) {
+								operands[top - 1] = 1;
+								current += static_cast<size_t>(instruction.value);
+							}
+
+							break;
+						case Type::OPERATOR:
+							if (arity(instruction.op) == 1) {
+								apply(instruction.op, operands[top - 1]);
+							} else if (arity(instruction.op) == 3) {
+								operands[top - 3] = Arithmetic::clamp(operands[top - 3], operands[top - 2], operands[top - 1]);
+								top -= 2;
+							} else if (const auto error = apply(instruction.op, operands[top - 2], operands[top - 1]); error != Error::NONE) {
+								return {0, error, instruction.position, nullptr};
+							} else {
+								--top;
+							}
+
+							break;
+					}
+				}
+
+				return {operands[0], Error::NONE, 0, nullptr};
+			}
+
+			/**
+			 * @brief Applies the unary operator @p op to @p right, the same way the unchecked BasicOperator does.
+			 */
+			static constexpr void apply(OperatorKind op, T& right) {
+				switch (op) {
+					case OperatorKind::NEGATE: right = Arithmetic::negate(right); break;
+					case OperatorKind::NOT: right = !right; break;
+					case OperatorKind::PRE_INCREMENT: right = Arithmetic::add(right, T{1}); break;
+					case OperatorKind::PRE_DECREMENT: right = Arithmetic::subtract(right, T{1}); break;
+					case OperatorKind::ABS: right = Arithmetic::absolute(right); break;
+					default: break;
+				}
+			}
+
+			/**
+			 * @brief Applies the binary operator @p op to @p left and @p right, the same way the unchecked BasicOperator does.
+			 * @return Error::NONE, or the reason @p op could not be applied.
+			 */
+			static constexpr Error apply(OperatorKind op, T& left, T right) {
+				switch (op) {
+					case OperatorKind::POWER:
+						// A negative integer power of zero divides by zero
+						if (Arithmetic::power_divides_by_zero(left, right)) { return Error::DIVISION_BY_ZERO; }
+						left = Arithmetic::power(left, right);
+						break;
+					case OperatorKind::MULTIPLY: left = Arithmetic::multiply(left, right); break;
+					case OperatorKind::DIVIDE:
+						if (right == 0) { return Error::DIVISION_BY_ZERO; }
+						left = Arithmetic::divide(left, right);
+						break;
+					case OperatorKind::REMAINDER:
+						if (right == 0) { return Error::REMAINDER_BY_ZERO; }
+						left = Arithmetic::remainder(left, right);
+						break;
+					case OperatorKind::ADD: left = Arithmetic::add(left, right); break;
+					case OperatorKind::SUBTRACT: left = Arithmetic::subtract(left, right); break;
+					case OperatorKind::GREATER: left = left > right; break;
+					case OperatorKind::GREATER_OR_EQUAL: left = left >= right; break;
+					case OperatorKind::LESS: left = left < right; break;
+					case OperatorKind::LESS_OR_EQUAL: left = left <= right; break;
+					case OperatorKind::EQUAL: left = left == right; break;
+					case OperatorKind::NOT_EQUAL: left = left != right; break;
+					case OperatorKind::AND: left = left && right; break;
+					case OperatorKind::OR: left = left || right; break;
+					case OperatorKind::MIN: left = Arithmetic::minimum(left, right); break;
+					case OperatorKind::MAX: left = Arithmetic::maximum(left, right); break;
+					default: break;
+				}
+
+				return Error::NONE;
+			}
+	};
+
+	/**
+	 * @brief Evaluates the literal equation @p equation. In a constant expression the compiler computes the result,
+	 * and an ill formed equation is a compile error.
+	 *
+	 * Example usage:
+	 * @code
+	 * constexpr auto area = InfixParser::eval("(2 + 3) * 5");
+	 * constexpr auto big = InfixParser::eval<int64_t>("2 ^ 40");
+	 * @endcode
+	 *
+	 * @param[in] equation The equation to evaluate.
+	 * @return The value of @p equation.
+	 * @throws EvaluationException When @p equation is ill formed or fails to evaluate outside of a constant expression.
+	 * @tparam T The type of the value. One of int, int64_t or __int128.
+	 */
+	template<class T = int, size_t N>
+	constexpr T eval(const char (&equation)[N]) {
+		return ConstantEvaluator<T, N>{}.evaluate(std::string_view{equation, N - 1});
+	}
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+// STD
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// InfixParser
+#include <InfixParser/InfixParser.hpp>
+
+namespace InfixParser {
+	template<class T>
+	class BasicOperator;
+
+	/**
+	 * @brief The reasons an equation can fail to compile or evaluate.
+	 */
+	enum class Error : uint8_t {
+		/** The equation was evaluated. */
+		NONE,
+
+		/** The equation is empty. */
+		EMPTY_EQUATION,
+
+		/** A number does not fit in the value type. */
+		NUMBER_TOO_LARGE,
+
+		/** A token is not a known operator. */
+		UNKNOWN_OPERATOR,
+
+		/** A variable is not in the layout the equation is compiled with, or variables are not allowed. */
+		UNKNOWN_VARIABLE,
+
+		/** An operand follows another operand. */
+		EXPECTED_OPERATOR,
+
+		/** A binary operator or ")" is missing its left operand. */
+		EXPECTED_OPERAND,
+
+		/** The equation ends with an operator. */
+		EXPECTED_FINAL_OPERAND,
+
+		/** A ")" has no matching "(". */
+		EXTRANEOUS_PARENTHESIS,
+
+		/** Operands are left over once every operator has been applied. */
+		TOO_MANY_OPERANDS,
+
+		/** An operator has fewer operands than its arity. */
+		MISSING_OPERANDS,
+
+		/** A function is called with more or fewer arguments than its arity. */
+		WRONG_ARGUMENT_COUNT,
+
+		/** A "," is not between the arguments of a function call. */
+		MISPLACED_COMMA,
+
+		/** The right side of / is zero. */
+		DIVISION_BY_ZERO,
+
+		/** The right side of % is zero. */
+		REMAINDER_BY_ZERO,
+
+		/** The result of a checked Operator does not fit in the value type. */
+		INTEGER_OVERFLOW,
+	};
+
+	/**
+	 * @brief Get a description of @p error that does not depend on the equation it occurred in.
+	 * @param[in] error The error to describe.
+	 * @return The description of @p error.
+	 */
+	const char* to_string(Error error);
+
+	/**
+	 * @brief Builds a message that shows where in @p equation an error occurred.
+	 * @param[in] equation The equation the error occurred in.
+	 * @param[in] error The description of the error.
+	 * @param[in] pos The position in @p equation the error occurred at.
+	 * @return The message.
+	 */
+	std::string annotate(std::string_view equation, std::string_view error, size_t pos);
+
+	/**
+	 * @brief The result of evaluating an equation without throwing.
+	 * Errors are recorded as a code and a position. The message describing them is only built when asked for.
+	 *
+	 * Example usage:
+	 * @code
+	 * auto result = evaluator.try_evaluate(equation);
+	 *
+	 * if (!result.ok()) {
+	 *     std::cerr << result.message(equation);
+	 * }
+	 * @endcode
+	 *
+	 * @tparam T The type of the value. One of int, int64_t, __int128 or double.
+	 */
+	template<class T>
+	struct BasicEvaluationResult {
+		/** The value of the equation. Zero if it could not be evaluated. */
+		T value = 0;
+
+		/** Why the equation could not be evaluated. Error::NONE if it was evaluated. */
+		Error error = Error::NONE;
+
+		/** The position in the equation the error occurred at. */
+		size_t position = 0;
+
+		/** The Operator the error occurred in, if any. */
+		const BasicOperator<T>* op = nullptr;
+
+		/**
+		 * @brief Checks if the equation was evaluated.
+		 * @return True if the equation was evaluated, false if it produced an error.
+		 */
+		bool ok() const;
+
+		/**
+		 * @brief Get a description of the error.
+		 * @param[in] equation The equation that was evaluated.
+		 * @return The description of the error. Empty if there is no error.
+		 */
+		std::string description(std::string_view equation) const;
+
+		/**
+		 * @brief Get the message an EvaluationException for the error would have.
+		 * @param[in] equation The equation that was evaluated.
+		 * @return The description of the error annotated with where it occurred. Empty if there is no error.
+		 */
+		std::string message(std::string_view equation) const;
+	};
+
+	/** The result of evaluating an equation of ints without throwing. */
+	using EvaluationResult = BasicEvaluationResult<int>;
+
+	extern template struct BasicEvaluationResult<int>;
+	extern template struct BasicEvaluationResult<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	extern template struct BasicEvaluationResult<__int128>;
+#endif
+	extern template struct BasicEvaluationResult<double>;
+}
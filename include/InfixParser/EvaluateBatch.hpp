@@ -0,0 +1,36 @@
+#pragma once
+
+// STD
+#include <string>
+#include <string_view>
+#include <vector>
+
+// InfixParser
+#include <InfixParser/Error.hpp>
+#include <InfixParser/ThreadPool.hpp>
+
+namespace InfixParser {
+	/**
+	 * @brief Evaluates each of the @p count equations in @p equations across the workers of @p pool.
+	 * Each worker thread uses its own Evaluator, so no evaluator state is shared between threads.
+	 *
+	 * Example usage:
+	 * @code
+	 * std::vector<std::string_view> equations = {"1+2", "3*(4", "5/0"};
+	 * auto results = evaluate_batch(equations.data(), equations.size(), ThreadPool::global());
+	 * @endcode
+	 *
+	 * @param[in] equations The equations to evaluate.
+	 * @param[in] count The number of equations.
+	 * @param[in] pool The thread pool to evaluate the equations with.
+	 * @return The result of each equation, in the same order as @p equations. Errors are reported per equation
+	 *         and their messages are only built when asked for with EvaluationResult::message().
+	 */
+	std::vector<EvaluationResult> evaluate_batch(const std::string_view* equations, size_t count, ThreadPool& pool);
+
+	/**
+	 * @brief Evaluates each equation in @p equations across the workers of @p pool.
+	 * @see evaluate_batch(const std::string_view*, size_t, ThreadPool&)
+	 */
+	std::vector<EvaluationResult> evaluate_batch(const std::vector<std::string_view>& equations, ThreadPool& pool = ThreadPool::global());
+}
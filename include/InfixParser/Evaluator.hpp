@@ -1,19 +1,36 @@
 #pragma once
 
 // STD
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
-#include <stack>
+#include <stdexcept>
 
 // InfixParser
+#include <InfixParser/Error.hpp>
 #include <InfixParser/Operator.hpp>
+#include <InfixParser/OperatorRegistry.hpp>
+#include <InfixParser/CompiledExpression.hpp>
+#include <InfixParser/ShuntingYard.hpp>
 
 namespace InfixParser {
 	class EvaluationException : public std::runtime_error {
 		using runtime_error::runtime_error;
 	};
 
+	/**
+	 * @brief Creates an annotated exception.
+	 * @param[in] equation The original equation.
+	 * @param[in] error The error message.
+	 * @param[in] pos The position where the error occured.
+	 * @throw EvaluationException
+	 */
+	[[noreturn]] void throw_annotated(std::string_view equation, std::string_view error, size_t pos);
+
 	/**
 	 * @brief Used to evaluate an infix string equation.
 	 *
@@ -22,66 +39,316 @@ namespace InfixParser {
 	 * Evaluator evaluator;
 	 * auto result = evaluator.evaluate("(1+2)*3");
 	 * @endcode
+	 *
+	 * Equations passed to evaluate() may not contain variables. Use compile() to bind variables.
+	 * Use try_evaluate() when ill formed equations are expected, to avoid the cost of an exception.
+	 *
+	 * The right side of && is only evaluated when its left side is true, and the right side of || only when its left side is false.
+	 * Errors in a side that is not evaluated, such as division by zero, are not reported.
+	 *
+	 * Integer arithmetic is exact. / rounds half away from zero, and ^ with a negative exponent rounds the same way.
+	 * Results that do not fit in the value type wrap, unless checked arithmetic is enabled with set_checked().
+	 * Double arithmetic follows IEEE 754: / is not rounded, % is the remainder of std::fmod and ^ is std::pow.
+	 * Division and remainder by zero are errors for every value type. A negative power of zero is an error for integers only.
+	 * Double literals are written as integers, such as 2, and may be larger than any integer type.
+	 *
+	 * The built-in functions abs(x), min(x, y), max(x, y) and clamp(x, low, high) are called by name. Each is a single instruction,
+	 * so they are cheaper than building the same result from comparisons. A name that is not followed by ( is a variable.
+	 *
+	 * Use Evaluator for ints, Int64Evaluator, Int128Evaluator or DoubleEvaluator for the other value types.
+	 * Operators are looked up in a BasicOperatorRegistry, which can add operators to the predefined ones.
+	 *
+	 * When the library is built with INFIXPARSER_STATS defined, each evaluator counts the work it does. See statistics().
+	 *
+	 * @tparam T The type of the value. One of int, int64_t, __int128 or double.
 	 */
-	class Evaluator {
+	template<class T>
+	class BasicEvaluator : private ShuntingYard<BasicEvaluator<T>, T, const BasicOperator<T>*, Stack, 64> {
 		public:
+			/**
+			 * @brief The work an evaluator has done. Only counted when the library is built with INFIXPARSER_STATS defined.
+			 *
+			 * An evaluator is only used by one thread at a time, so it counts without synchronization.
+			 * Add up the snapshots of the evaluators of each thread with += to get the totals.
+			 */
+			struct Statistics {
+				/** The number of equations evaluated or compiled. */
+				uint64_t equations = 0;
+
+				/** The number of numbers, names and operator tokens read. */
+				uint64_t tokens = 0;
+
+				/** The number of times operators of each OperatorKind were applied by evaluate() and try_evaluate(), indexed by kind. */
+				std::array<uint64_t, operator_kinds> applied = {};
+
+				/** The most operands any equation needed on the stack at once. */
+				uint64_t max_operands = 0;
+
+				/** The most operators waiting on the stack at once while converting an equation. */
+				uint64_t max_operators = 0;
+
+				/** The number of EvaluationExceptions thrown. */
+				uint64_t exceptions = 0;
+
+				/** The time spent converting equations into instructions. Tokens are read while converting, so this includes reading them. */
+				std::chrono::nanoseconds converting{0};
+
+				/** The time spent running the instructions of evaluate() and try_evaluate(). */
+				std::chrono::nanoseconds applying{0};
+
+				/**
+				 * @brief Get the number of times operators of the same kind as @p op were applied.
+				 * Checked operators are counted with the operators they check, and registered operators are counted together.
+				 * @param[in] op The Operator.
+				 * @return The number of times operators of the kind of @p op were applied.
+				 */
+				uint64_t applications(const BasicOperator<T>* op) const;
+
+				/**
+				 * @brief Adds the counts of @p other to these, keeping the larger of each maximum.
+				 * @param[in] other The statistics to add.
+				 * @return These statistics.
+				 */
+				Statistics& operator+=(const Statistics& other);
+			};
+
 			/**
 			 * @brief Constructs an evaluator.
+			 * @param[in] registry The operators to recognize. Must outlive this evaluator and the expressions it compiles.
+			 * @throws OperatorRegistryException When @p registry is not frozen.
 			 */
-			Evaluator();
+			explicit BasicEvaluator(const BasicOperatorRegistry<T>& registry = BasicOperatorRegistry<T>::predefined());
+
+			/**
+			 * @brief Sets if equations evaluated or compiled from now on report Error::INTEGER_OVERFLOW when a result
+			 * of -, ++, --, ^, *, /, +, - or abs does not fit in the value type, instead of wrapping. Has no effect on doubles.
+			 * @param[in] checked True to check for overflow, false to wrap.
+			 */
+			void set_checked(bool checked);
+
+			/**
+			 * @brief Checks if overflow is reported.
+			 * @return True if overflow is reported, false if results wrap.
+			 */
+			bool is_checked() const;
 
 			/**
 			 * @brief Evaluates the equation @p equation and returns the result.
+			 * @throws EvaluationException When @p equation is ill formed or fails to evaluate.
+			 */
+			T evaluate(std::string_view equation);
+
+			/**
+			 * @brief Evaluates the equation @p equation without throwing.
+			 * Once the evaluator has warmed up, neither ill formed nor valid equations allocate.
+			 * @return The value of @p equation, or the error that prevented it from being evaluated.
+			 */
+			BasicEvaluationResult<T> try_evaluate(std::string_view equation);
+
+			/**
+			 * @brief Compiles the equation @p equation into a CompiledExpression that can be run repeatedly.
+			 * Variables are assigned slots in the order they first appear in @p equation.
+			 * @throws EvaluationException When @p equation is ill formed.
 			 */
-			int evaluate(const std::string& equation);
+			BasicCompiledExpression<T> compile(std::string_view equation);
+
+			/**
+			 * @brief Compiles the equation @p equation into a CompiledExpression that can be run repeatedly.
+			 * Variables are assigned the slot of their name in @p variables. This allows many expressions to share a layout.
+			 * @throws EvaluationException When @p equation is ill formed or uses a variable not in @p variables.
+			 */
+			BasicCompiledExpression<T> compile(std::string_view equation, const std::vector<std::string>& variables);
+
+			/**
+			 * @brief Get a snapshot of the work this evaluator has done since it was constructed or last reset.
+			 * @return The statistics. Always empty unless the library is built with INFIXPARSER_STATS defined.
+			 */
+			Statistics statistics() const;
+
+			/**
+			 * @brief Resets the statistics to zero.
+			 */
+			void reset_statistics();
 
 		private:
+			/** Converts equations with the shunting-yard algorithm shared with eval() */
+			using ShuntingYard = InfixParser::ShuntingYard<BasicEvaluator<T>, T, const BasicOperator<T>*, Stack, 64>;
+			friend ShuntingYard;
+
+			/** The types used with values of type T */
+			using Instruction = BasicInstruction<T>;
+			using Operator = BasicOperator<T>;
+			using OperandStack = BasicOperandStack<T>;
+			using EvaluationResult = BasicEvaluationResult<T>;
+			using CompiledExpression = BasicCompiledExpression<T>;
+			using typename ShuntingYard::Type;
+
+			/** The state of the conversion */
+			using ShuntingYard::operators;
+			using ShuntingYard::position;
+			using ShuntingYard::max_stack_depth;
+			using ShuntingYard::error_position;
+			using ShuntingYard::error_operator;
+			using ShuntingYard::no_jump;
+			using ShuntingYard::build;
+
+			/** The operators to recognize */
+			const BasicOperatorRegistry<T>* registry;
+
 			/** Stores all active operands */
 			OperandStack operands;
 
-			/** Stores all active operators */
-			std::stack<const Operator*> operators;
+			/** Stores the instructions emitted so far */
+			std::vector<Instruction> program;
+
+			/** The variable names indexed by slot */
+			std::vector<std::string> variables;
+
+			/** True if unknown variables should be assigned a new slot */
+			bool declare_variables = false;
+
+			/** The index of the first instruction of each operand on the stack after the emitted instructions have run */
+			Stack<size_t, 64> operand_begins;
+
+			/** True if emitted operators should report overflow */
+			bool checked = false;
 
-			/** The current operator depth */
-			int operator_depth = 1;
+			/** True if emitted operators should be optimized. Only worthwhile when the program is run more than once. */
+			bool optimizing = false;
 
-			/** True if an operand is expected. Used only for error reporting. */
-			bool expect_operand = true;
+			/** The work done so far. Present whether or not INFIXPARSER_STATS is defined, so the layout never depends on it. */
+			Statistics stats;
+
+			/**
+			 * @brief Builds @p equation, timing the conversion when INFIXPARSER_STATS is defined.
+			 * @param[in] equation The equation to convert.
+			 * @return Error::NONE, or the reason @p equation is ill formed.
+			 */
+			Error parse(std::string_view equation);
+
+			/**
+			 * @brief Builds @p equation and copies #program into a CompiledExpression.
+			 * @param[in] equation The equation to compile.
+			 * @return The compiled expression.
+			 * @throws EvaluationException When @p equation is ill formed.
+			 */
+			CompiledExpression link(std::string_view equation);
 
 			/**
-			 * @brief Reads the next valid token in the string [@p begin, @p end).
-			 * After this function is called @p begin points to one past the end of the token.
+			 * @brief Simplifies the operator instruction at the end of #program.
+			 * Folds operators whose operands are constant, cancels redundant chains of unary operators
+			 * and applies algebraic identities. Only rewrites that cannot change the result or the errors
+			 * of the program are made. Operators that fail on constant operands are left to fail when run.
 			 *
-			 * @param[in,out] begin The start of the string to read from.
+			 * @param[in] left The index of the first instruction of the first operand of the operator.
+			 * @param[in] right The index of the first instruction of the last operand of the operator.
+			 */
+			void optimize(size_t left, size_t right);
+
+			/**
+			 * @brief Replaces the instructions of #program from @p begin onwards with a single constant.
+			 * @param[in] begin The index of the first instruction to replace.
+			 * @param[in] value The value of the constant.
+			 */
+			void replace(size_t begin, T value);
+
+			/** @brief Get the kind of @p op. */
+			static OperatorKind kind(const Operator* op);
+
+			/** @brief Get the precedence of @p op. */
+			static int precedence(const Operator* op);
+
+			/** @brief Checks if @p op is right associative. */
+			static bool is_right_associative(const Operator* op);
+
+			/** @brief Get the number of operands @p op consumes. */
+			static int arity(const Operator* op);
+
+			/** @brief Finds the end of the whitespace at @p begin with InfixParser::skip_whitespace. */
+			static const char* skip_whitespace(const char* begin, const char* end);
+
+			/** @brief Reads the number at @p begin with InfixParser::read_number. */
+			static bool read_number(const char*& begin, const char* end, T& value);
+
+			/**
+			 * @brief Reads the operator token at @p begin from #registry.
+			 * @param[in,out] begin The start of the token. Moved past the token.
 			 * @param[in] end The end of the string to read from.
-			 * @return The operator the read token represents. nullptr if no valid token could be read.
+			 * @param[in] prefix True if an operand is expected.
+			 * @return The operator the token represents. nullptr if no valid token could be read.
 			 */
-			const Operator* read_token(std::string::const_iterator& begin, const std::string::const_iterator& end);
+			const Operator* match(const char*& begin, const char* end, bool prefix) const;
 
 			/**
-			 * @brief Reads and processes the next token in the string defined by [@p begin, @p end).
-			 * After this function is called @p begin points to one past the end of the token.
-			 *
-			 * @param[in,out] begin The beginning of the string to convert and evaluate.
-			 * @param[in] end The beginning of the string to convert and evaluate.
-			 * @throws EquationException When there is no token to read.
+			 * @brief Get the built-in function called @p name.
+			 * @return The function. nullptr if there is no built-in function called @p name.
+			 */
+			const Operator* find_function(std::string_view name) const;
+
+			/**
+			 * @brief Gets the slot of the variable @p name.
+			 * @param[in] name The name of the variable.
+			 * @param[out] slot The slot of the variable.
+			 * @return False when @p name is unknown and new variables are not allowed, true otherwise.
+			 */
+			bool resolve(std::string_view name, int& slot);
+
+			/**
+			 * @brief Empties #program and the operand bookkeeping before an equation is converted.
+			 */
+			void begin_program();
+
+			/**
+			 * @brief Appends an instruction that pushes an operand to #program.
+			 * @param[in] type The type of the instruction.
+			 * @param[in] value The value or variable slot to push.
 			 */
-			void handle_token(std::string::const_iterator& begin, const std::string::const_iterator& end);
+			void emit_operand(Type type, T value);
 
 			/**
-			 * @brief Handles the processing of @p op.
-			 * @param[in] op The Operator to evaluate.
-			 * @throws EquationException
+			 * @brief Appends an instruction that applies @p op to #program, and optimizes it when compiling.
+			 * @param[in] op The Operator to apply. Replaced by its checked version when overflow is reported.
+			 * @param[in] arity The number of operands of @p op.
+			 * @param[in] jump The index of the jump that skips to @p op, or no_jump.
 			 */
-			void handle_operator(const Operator* op);
+			void emit_operator(const Operator* op, size_t arity, size_t jump);
 
 			/**
-			 * @brief Creates an annotated exception.
-			 * @param[in] equation The original equation.
-			 * @param[in] error The error message.
-			 * @param[in] pos The position where the error occured.
-			 * @throw EquationException
+			 * @brief Appends the jump that skips the right side of && or || to #program. The jump is completed by emit_operator().
+			 * @param[in] type Type::JUMP_IF_FALSE for &&, Type::JUMP_IF_TRUE for ||.
+			 * @return The index of the jump.
 			 */
-			void throw_annotated(const std::string& equation, std::string error, size_t pos);
+			size_t emit_jump(Type type);
+
+			/**
+			 * @brief Counts a token read when INFIXPARSER_STATS is defined.
+			 */
+			void lexed_token();
+
+			/**
+			 * @brief Records the number of waiting operators when INFIXPARSER_STATS is defined.
+			 */
+			void pushed_operator();
 	};
+
+	/** Evaluates equations of ints. */
+	using Evaluator = BasicEvaluator<int>;
+
+	/** Evaluates equations of 64 bit integers. */
+	using Int64Evaluator = BasicEvaluator<int64_t>;
+
+#if defined(INFIXPARSER_INT128)
+	/** Evaluates equations of 128 bit integers. Only available where the compiler supports __int128. */
+	using Int128Evaluator = BasicEvaluator<__int128>;
+#endif
+
+	/** Evaluates equations of doubles. */
+	using DoubleEvaluator = BasicEvaluator<double>;
+
+	extern template class BasicEvaluator<int>;
+	extern template class BasicEvaluator<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	extern template class BasicEvaluator<__int128>;
+#endif
+	extern template class BasicEvaluator<double>;
 }
\ No newline at end of file
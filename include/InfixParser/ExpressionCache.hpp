@@ -0,0 +1,151 @@
+#pragma once
+
+// STD
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+#include <cstdint>
+
+// InfixParser
+#include <InfixParser/CompiledExpression.hpp>
+
+namespace InfixParser {
+	/**
+	 * @brief A thread-safe cache of CompiledExpressions keyed by their equation.
+	 *
+	 * The cache is split into shards that are locked independently. Lookups that hit only take a shared lock,
+	 * so threads reading the same equation never wait on each other. Each shard holds a bounded number of
+	 * expressions and evicts the least recently used ones using the CLOCK algorithm.
+	 *
+	 * Example usage:
+	 * @code
+	 * auto expression = ExpressionCache::global().get("(a+b)*3");
+	 * auto result = expression->run(values);
+	 * @endcode
+	 */
+	class ExpressionCache {
+		public:
+			/**
+			 * @brief A snapshot of the counters of an ExpressionCache.
+			 */
+			struct Statistics {
+				/** The number of lookups that found a cached expression. */
+				uint64_t hits;
+
+				/** The number of lookups that had to compile an expression. */
+				uint64_t misses;
+
+				/** The number of expressions removed to make space for new ones. */
+				uint64_t evictions;
+
+				/** The number of expressions currently cached. */
+				size_t size;
+			};
+
+			/**
+			 * @brief Constructs a cache.
+			 * @param[in] capacity The maximum number of expressions to cache.
+			 * @param[in] shards The number of independently locked shards. Rounded up to a power of two.
+			 */
+			explicit ExpressionCache(size_t capacity, size_t shards = 16);
+
+			ExpressionCache(const ExpressionCache&) = delete;
+			ExpressionCache& operator=(const ExpressionCache&) = delete;
+
+			/**
+			 * @brief Gets the compiled form of @p equation, compiling and caching it if needed.
+			 * @param[in] equation The equation to get.
+			 * @return The compiled form of @p equation. Remains valid after it is evicted.
+			 * @throws EvaluationException When @p equation is ill formed. Ill formed equations are not cached.
+			 */
+			std::shared_ptr<const CompiledExpression> get(const std::string& equation);
+
+			/**
+			 * @brief Get a snapshot of the counters of this cache.
+			 * @return A snapshot of the counters of this cache.
+			 */
+			Statistics statistics() const;
+
+			/**
+			 * @brief Removes every expression from this cache. Does not reset the counters.
+			 */
+			void clear();
+
+			/**
+			 * @brief Get the process-wide cache.
+			 * @return The process-wide cache.
+			 */
+			static ExpressionCache& global();
+
+		private:
+			/** A cached expression */
+			struct Entry {
+				/** The compiled expression */
+				std::shared_ptr<const CompiledExpression> expression;
+
+				/** True if the expression has been used since the clock hand last passed it */
+				mutable std::atomic<bool> referenced{true};
+			};
+
+			/** An independently locked part of the cache */
+			struct alignas(64) Shard {
+				/** Guards every other member */
+				mutable std::shared_mutex mutex;
+
+				/** The cached expressions */
+				std::unordered_map<std::string, Entry> entries;
+
+				/** The elements of #entries in clock order */
+				std::vector<std::pair<const std::string, Entry>*> clock;
+
+				/** The index in #clock the next eviction starts from */
+				size_t hand = 0;
+			};
+
+			/** A counter that is split across cache lines to avoid contention between threads */
+			class Counter {
+				public:
+					/** Increments the counter. */
+					void increment();
+
+					/** @return The current value of the counter. */
+					uint64_t value() const;
+
+				private:
+					/** A single cache line of the counter */
+					struct alignas(64) Stripe {
+						std::atomic<uint64_t> value{0};
+					};
+
+					/** The stripes of the counter */
+					Stripe stripes[16];
+			};
+
+			/** The maximum number of expressions in each shard */
+			size_t shard_capacity;
+
+			/** The shards of this cache */
+			std::vector<Shard> shards;
+
+			/** The number of lookups that found a cached expression */
+			Counter hits;
+
+			/** The number of lookups that had to compile an expression */
+			Counter misses;
+
+			/** The number of expressions removed to make space for new ones */
+			Counter evictions;
+
+			/**
+			 * @brief Inserts @p expression into @p shard, evicting an expression if the shard is full.
+			 * The caller must hold a unique lock on the shard.
+			 * @param[in,out] shard The shard to insert into.
+			 * @param[in] equation The equation of the expression.
+			 * @param[in] expression The compiled expression.
+			 */
+			void insert(Shard& shard, const std::string& equation, std::shared_ptr<const CompiledExpression> expression);
+	};
+}
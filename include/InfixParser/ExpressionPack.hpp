@@ -0,0 +1,171 @@
+#pragma once
+
+// STD
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// InfixParser
+#include <InfixParser/CompiledExpression.hpp>
+#include <InfixParser/MappedFile.hpp>
+
+namespace InfixParser {
+	class ExpressionPackException : public std::runtime_error {
+		using runtime_error::runtime_error;
+	};
+
+	/**
+	 * @brief Compiled expressions saved to a file that runs them straight from memory once it is mapped.
+	 *
+	 * A pack stores the operations each expression runs, along with its equation, variable names and the position
+	 * each instruction came from for error reporting. Every reference within the file is an offset from its start,
+	 * so loading a pack only maps it and checks it. Expressions are neither parsed nor copied.
+	 *
+	 * Example usage:
+	 * @code
+	 * Evaluator evaluator;
+	 * ExpressionPack::write("rules.pack", {evaluator.compile("price * quantity > limit")});
+	 *
+	 * ExpressionPack pack{"rules.pack"};
+	 * const int values[] = {25, 4, 90}; // In the order of pack.variables(0)
+	 * auto result = pack.run(0, values, operands);
+	 * @endcode
+	 *
+	 * Packs start with a version, a description of the value type and byte order they were written with,
+	 * and a checksum of their contents. Loading a pack that is corrupt, truncated or written for a
+	 * different version, value type or platform throws. Only expressions of the predefined operators can be saved.
+	 *
+	 * @tparam T The type of the values. One of int, int64_t, __int128 or double.
+	 */
+	template<class T>
+	class BasicExpressionPack {
+		public:
+			/**
+			 * @brief Maps the pack at @p path and checks it.
+			 * @param[in] path The path of the pack.
+			 * @throws MappedFileException When the file cannot be opened or mapped.
+			 * @throws ExpressionPackException When the file is not a valid pack of values of type T.
+			 */
+			explicit BasicExpressionPack(const std::string& path);
+
+			/**
+			 * @brief Saves @p expressions as a pack at @p path, replacing any existing file.
+			 * @param[in] path The path of the pack.
+			 * @param[in] expressions The expressions to save.
+			 * @throws ExpressionPackException When an expression uses a registered Operator, or the file cannot be written.
+			 */
+			static void write(const std::string& path, const std::vector<BasicCompiledExpression<T>>& expressions);
+
+			/**
+			 * @brief Runs expression @p index with the variable values @p values without throwing.
+			 * @param[in] index The index of the expression. Must be less than size().
+			 * @param[in] values The value of each variable, indexed by slot. See variables().
+			 * @param[in,out] operands The operand stack to use. Any existing contents are discarded.
+			 * @return The result, or the error and the position of the Operator that failed to apply.
+			 */
+			BasicEvaluationResult<T> try_run(size_t index, const T* values, BasicOperandStack<T>& operands) const;
+
+			/**
+			 * @brief Runs expression @p index with the variable values @p values and returns the result.
+			 * @param[in] index The index of the expression. Must be less than size().
+			 * @param[in] values The value of each variable, indexed by slot. See variables().
+			 * @param[in,out] operands The operand stack to use. Any existing contents are discarded.
+			 * @throws EvaluationException When an Operator fails to apply.
+			 */
+			T run(size_t index, const T* values, BasicOperandStack<T>& operands) const;
+
+			/**
+			 * @brief Copies expression @p index out of the pack.
+			 * @param[in] index The index of the expression. Must be less than size().
+			 * @return The expression, which remains valid after this pack is destroyed.
+			 */
+			BasicCompiledExpression<T> expression(size_t index) const;
+
+			/**
+			 * @brief Get the equation expression @p index was compiled from.
+			 * @param[in] index The index of the expression. Must be less than size().
+			 * @return The equation, stored in the mapped file.
+			 */
+			std::string_view equation(size_t index) const;
+
+			/**
+			 * @brief Get the names of the variables used by expression @p index.
+			 * The index of a name is the slot its value is read from when running.
+			 * @param[in] index The index of the expression. Must be less than size().
+			 * @return The names of the variables, stored in the mapped file.
+			 */
+			std::vector<std::string_view> variables(size_t index) const;
+
+			/**
+			 * @brief Get the number of expressions.
+			 * @return The number of expressions.
+			 */
+			size_t size() const;
+
+		private:
+			/** The types used with values of type T */
+			using Instruction = BasicInstruction<T>;
+			using Operator = BasicOperator<T>;
+			using CompiledExpression = BasicCompiledExpression<T>;
+			using Operation = typename CompiledExpression::Operation;
+			using Code = typename CompiledExpression::Code;
+
+			/** The file layout. See ExpressionPack.cpp. */
+			struct Header;
+			struct Entry;
+			struct Name;
+			struct Record;
+
+			/** The mapped file */
+			MappedFile file;
+
+			/** The entry of each expression */
+			const Entry* entries = nullptr;
+
+			/** The number of expressions */
+			size_t count = 0;
+
+			/**
+			 * @brief Get the entry of expression @p index.
+			 * @param[in] index The index of the expression. Must be less than size().
+			 * @return The entry.
+			 */
+			const Entry& entry(size_t index) const;
+
+			/**
+			 * @brief Get the object of type U at @p offset in the file.
+			 * @param[in] offset The offset from the start of the file.
+			 * @return The object.
+			 */
+			template<class U>
+			const U* at(uint64_t offset) const;
+
+			/**
+			 * @brief Rebuilds the instructions of @p entry.
+			 * @param[in] entry The entry of the expression.
+			 * @return The instructions in postfix order.
+			 */
+			std::vector<Instruction> instructions(const Entry& entry) const;
+
+			/**
+			 * @brief Checks that the entry of expression @p index lies within the file and describes a program that can be run safely.
+			 * @param[in] index The index of the expression.
+			 * @param[in,out] jumps Scratch space for the jumps that have not landed yet.
+			 * @throws ExpressionPackException When the entry is invalid.
+			 */
+			void validate(size_t index, std::vector<std::pair<uint32_t, uint32_t>>& jumps) const;
+	};
+
+	/** Compiled expressions of ints saved to a file. */
+	using ExpressionPack = BasicExpressionPack<int>;
+
+	extern template class BasicExpressionPack<int>;
+	extern template class BasicExpressionPack<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	extern template class BasicExpressionPack<__int128>;
+#endif
+	extern template class BasicExpressionPack<double>;
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+// STD
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// InfixParser
+#include <InfixParser/CompiledExpression.hpp>
+#include <InfixParser/Kernels.hpp>
+#include <InfixParser/Operator.hpp>
+
+namespace InfixParser {
+	/**
+	 * @brief Compiled expressions that are run together, with each subexpression they have in common run only once per row.
+	 *
+	 * The programs of the expressions are merged into a single graph where equal subexpressions are the same node,
+	 * so the same (a + b) * c in many expressions is computed once. Operands of +, *, ==, !=, && and ||, and of min and max
+	 * for integers, are put in a fixed order first, so b + a is the same node as a + b. The min and max of doubles keep their order,
+	 * since they return their left operand when the operands are unordered or are zeros of either sign.
+	 *
+	 * Example usage:
+	 * @code
+	 * Evaluator evaluator;
+	 * ExpressionSet set{{evaluator.compile("(a + b) * c > limit"), evaluator.compile("(a + b) * c - d")}};
+	 *
+	 * const int* columns[] = {as, bs, cs, limits, ds}; // In the order of set.variables()
+	 * int* results[] = {over_limit, remaining};        // In the order of the expressions
+	 * set.run_batch(columns, results, rows);
+	 * @endcode
+	 *
+	 * Both sides of && and || are run for every row. When an Operator fails to apply to a row, that block of rows is
+	 * run again one expression at a time, so errors are only reported for the rows and sides each expression would run.
+	 *
+	 * @tparam T The type of the values. One of int, int64_t, __int128 or double.
+	 */
+	template<class T>
+	class BasicExpressionSet {
+		public:
+			/**
+			 * @brief How much work sharing subexpressions saves.
+			 */
+			struct Statistics {
+				/** The number of expressions. */
+				size_t expressions;
+
+				/** The number of operators applied per row when running each expression on its own. */
+				size_t operations;
+
+				/** The number of operators applied per row when running the expressions together. */
+				size_t shared_operations;
+
+				/** The number of distinct subexpressions, including constants and variables. */
+				size_t nodes;
+			};
+
+			/**
+			 * @brief Merges @p expressions into one graph.
+			 * @param[in] expressions The expressions to run together.
+			 */
+			explicit BasicExpressionSet(std::vector<BasicCompiledExpression<T>> expressions);
+
+			/**
+			 * @brief Runs every expression with the variable values @p values.
+			 * @param[in] values The value of each variable, indexed by slot. See variables().
+			 * @param[out] results The array to store the result of each expression in, in the order of the expressions.
+			 * @throws EvaluationException When an Operator fails to apply.
+			 */
+			void run(const T* values, T* results) const;
+
+			/**
+			 * @brief Runs every expression once for each of @p rows rows.
+			 * @param[in] columns The values of each variable, indexed by slot. Each column must contain @p rows values. See variables().
+			 * @param[out] results The array to store the results of each expression in, in the order of the expressions.
+			 *             Each must contain space for @p rows values.
+			 * @param[in] rows The number of rows to evaluate.
+			 * @throws EvaluationException When an Operator fails to apply to a row.
+			 */
+			void run_batch(const T* const* columns, T* const* results, size_t rows) const;
+
+			/**
+			 * @brief Get the names of the variables used by any of the expressions.
+			 * The index of a name is the slot its value is read from when running.
+			 * @return The names of the variables, in the order they first appear in the expressions.
+			 */
+			const std::vector<std::string>& variables() const;
+
+			/**
+			 * @brief Get the expressions, in the order they were given.
+			 * @return The expressions.
+			 */
+			const std::vector<BasicCompiledExpression<T>>& expressions() const;
+
+			/**
+			 * @brief Get how much work sharing subexpressions saves.
+			 * @return The statistics of this set.
+			 */
+			Statistics statistics() const;
+
+		private:
+			/** The types used with values of type T */
+			using Instruction = BasicInstruction<T>;
+			using Operator = BasicOperator<T>;
+			using OperandStack = BasicOperandStack<T>;
+			using CompiledExpression = BasicCompiledExpression<T>;
+
+			/** A distinct subexpression */
+			struct Node {
+				/** The kind of node. Only Type::VALUE, Type::VARIABLE and Type::OPERATOR are used. */
+				typename Instruction::Type type;
+
+				/** The Operator applied to #operands. nullptr for values and variables. */
+				const Operator* op;
+
+				/** The constant value, or the slot of the variable */
+				T value;
+
+				/** The nodes of the operands. Only the first op->arity() are used. */
+				uint32_t operands[3];
+			};
+
+			/** A node applied to a block of rows, in the order they are run */
+			struct Step {
+				/** The node to run */
+				uint32_t node;
+
+				/** The kernel of the Operator of the node */
+				Kernels::Kernel kernel;
+
+				/** The index of the first output of this step in #outputs */
+				uint32_t first_output;
+
+				/** The number of expressions whose result is this node */
+				uint32_t output_count;
+			};
+
+			/** How the result of a node is stored while a block of rows is run */
+			struct Location {
+				/** True if the node is a variable read straight from its column */
+				bool column;
+
+				/** The column slot for variables, otherwise the block the node is stored in */
+				uint32_t index;
+			};
+
+			/** The expressions, in the order they were given */
+			std::vector<CompiledExpression> members;
+
+			/** The variable names indexed by slot */
+			std::vector<std::string> names;
+
+			/** The slot in #names of each variable of each expression */
+			std::vector<std::vector<size_t>> slots;
+
+			/** The distinct subexpressions. Operands always come before the nodes that use them. */
+			std::vector<Node> nodes;
+
+			/** The node whose value is the result of each expression */
+			std::vector<uint32_t> roots;
+
+			/** The operator nodes, in the order they are run */
+			std::vector<Step> steps;
+
+			/** The expressions whose result is computed by each step, grouped by step */
+			std::vector<uint32_t> outputs;
+
+			/** Where the result of each node is stored while a block is run */
+			std::vector<Location> locations;
+
+			/** The number of blocks needed to store the constants and the results of steps that are still needed */
+			size_t blocks = 0;
+
+			/** The number of operators applied per row when running each expression on its own */
+			size_t operation_count = 0;
+
+			/** The number of rows run at a time */
+			static constexpr size_t block_size = 256;
+
+			/**
+			 * @brief Assigns steps to the operator nodes and reuses the blocks of results that are no longer needed.
+			 */
+			void plan();
+
+			/**
+			 * @brief Fills the blocks of the constant nodes.
+			 * @param[out] storage Space for #blocks blocks of @p stride values.
+			 * @param[in] stride The number of values in each block of @p storage.
+			 */
+			void fill_constants(T* storage, size_t stride) const;
+
+			/**
+			 * @brief Runs every step for the rows [@p offset, @p offset + @p count).
+			 * @param[in] columns The values of each variable, indexed by slot.
+			 * @param[out] results The arrays to store the results of each expression in.
+			 * @param[in] offset The index of the first row.
+			 * @param[in] count The number of rows. At most @p stride.
+			 * @param[in,out] storage Space for #blocks blocks of @p stride values. The constants must already be filled in.
+			 * @param[in] stride The number of values in each block of @p storage.
+			 * @param[in,out] operands Scratch space for applying operators one row at a time.
+			 * @return True if every operator applied to every row, false if one failed and the rows must be run again one expression at a time.
+			 */
+			bool run_block(const T* const* columns, T* const* results, size_t offset, size_t count, T* storage, size_t stride, OperandStack& operands) const;
+
+			/**
+			 * @brief Runs each expression on its own for the rows [@p offset, @p offset + @p count).
+			 * @param[in] columns The values of each variable, indexed by slot.
+			 * @param[out] results The arrays to store the results of each expression in.
+			 * @param[in] offset The index of the first row.
+			 * @param[in] count The number of rows.
+			 * @throws EvaluationException When an Operator fails to apply to a row.
+			 */
+			void run_separately(const T* const* columns, T* const* results, size_t offset, size_t count) const;
+	};
+
+	/** Compiled expressions of ints that are run together. */
+	using ExpressionSet = BasicExpressionSet<int>;
+
+	extern template class BasicExpressionSet<int>;
+	extern template class BasicExpressionSet<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	extern template class BasicExpressionSet<__int128>;
+#endif
+	extern template class BasicExpressionSet<double>;
+}
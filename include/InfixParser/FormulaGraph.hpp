@@ -0,0 +1,229 @@
+#pragma once
+
+// STD
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// InfixParser
+#include <InfixParser/Error.hpp>
+#include <InfixParser/Evaluator.hpp>
+#include <InfixParser/CompiledExpression.hpp>
+#include <InfixParser/ThreadPool.hpp>
+
+namespace InfixParser {
+	class FormulaGraphException : public std::runtime_error {
+		using runtime_error::runtime_error;
+	};
+
+	/**
+	 * @brief A set of named formulas that reference each other by name, like the cells of a spreadsheet.
+	 *
+	 * Each name is either an input, set with set(), or a formula, set with define(). The variables of a formula are the names it references.
+	 * Changes are recorded until recompute() is called, which only recomputes the formulas downstream of a change. They are run in
+	 * topological order, a wave at a time, and large waves are split across the workers of a ThreadPool. A formula whose result
+	 * does not change stops the recomputation from going further down that path.
+	 *
+	 * Example usage:
+	 * @code
+	 * FormulaGraph graph;
+	 * graph.set("price", 12);
+	 * graph.define("total", "price * quantity");
+	 * graph.set("quantity", 3);
+	 * graph.recompute();
+	 * auto total = graph.value("total");
+	 * @endcode
+	 *
+	 * Names that are referenced before they are set or defined are inputs with the value 0.
+	 * A formula that fails, or that references a formula that failed, has the error of the formula that failed.
+	 * Definitions that would make a formula depend on itself are rejected, so the graph never has a cycle.
+	 * A FormulaGraph must only be used by one thread at a time.
+	 */
+	class FormulaGraph {
+		public:
+			/**
+			 * @brief Constructs an empty graph.
+			 * @param[in] pool The thread pool to recompute large waves of formulas with. Must outlive this graph.
+			 */
+			explicit FormulaGraph(ThreadPool& pool = ThreadPool::global());
+
+			FormulaGraph(const FormulaGraph&) = delete;
+			FormulaGraph& operator=(const FormulaGraph&) = delete;
+
+			/**
+			 * @brief Sets @p name to the formula @p equation, replacing any previous formula or input value.
+			 * @param[in] name The name of the formula.
+			 * @param[in] equation The formula. Its variables are the names it depends on.
+			 * @throws EvaluationException When @p equation is ill formed.
+			 * @throws FormulaGraphException When @p equation depends on @p name, directly or through other formulas.
+			 *         The graph is left unchanged.
+			 */
+			void define(const std::string& name, std::string_view equation);
+
+			/**
+			 * @brief Sets @p name to the input @p value, replacing any previous formula.
+			 * @param[in] name The name of the input.
+			 * @param[in] value The value of the input.
+			 */
+			void set(const std::string& name, int value);
+
+			/**
+			 * @brief Recomputes every formula that depends on a name set or defined since the last call.
+			 * Errors are stored in the result of the formulas they occur in rather than thrown.
+			 */
+			void recompute();
+
+			/**
+			 * @brief Get the result of @p name as of the last call to recompute().
+			 * @param[in] name The name of the input or formula.
+			 * @return The value of @p name, or the error of the formula that failed.
+			 * @throws FormulaGraphException When @p name is neither an input nor a formula.
+			 */
+			EvaluationResult result(const std::string& name) const;
+
+			/**
+			 * @brief Get the value of @p name as of the last call to recompute().
+			 * @param[in] name The name of the input or formula.
+			 * @return The value of @p name.
+			 * @throws FormulaGraphException When @p name is neither an input nor a formula.
+			 * @throws EvaluationException When the formula, or a formula it depends on, failed.
+			 */
+			int value(const std::string& name) const;
+
+			/**
+			 * @brief Checks if @p name is an input or a formula.
+			 * @param[in] name The name to check.
+			 * @return True if @p name is an input or a formula, false otherwise.
+			 */
+			bool contains(const std::string& name) const;
+
+			/**
+			 * @brief Get the number of inputs and formulas.
+			 * @return The number of inputs and formulas.
+			 */
+			size_t size() const;
+
+			/**
+			 * @brief Get the number of formulas run by the last call to recompute().
+			 * @return The number of formulas run by the last call to recompute().
+			 */
+			size_t recomputed() const;
+
+		private:
+			/** An input or a formula */
+			struct Node {
+				/** The name of the node */
+				std::string name;
+
+				/** The formula. nullptr for inputs. */
+				std::unique_ptr<const CompiledExpression> expression;
+
+				/** The node of each variable of #expression, indexed by slot */
+				std::vector<size_t> inputs;
+
+				/** The formulas that have this node as an input */
+				std::vector<size_t> dependents;
+
+				/** The value or error of this node */
+				EvaluationResult result;
+
+				/** The node the error of #result occurred in */
+				size_t origin = 0;
+
+				/** The traversal that last visited this node. See #epoch. */
+				uint64_t visited = 0;
+
+				/** The number of inputs that still need to be recomputed before this node can be */
+				size_t remaining = 0;
+
+				/** True if this node was set or defined since the last recompute */
+				bool stale = false;
+
+				/** True if #result changed in the current recompute */
+				bool changed = false;
+			};
+
+			/** The scratch space of a worker */
+			struct Scratch {
+				/** The operand stack to run formulas with */
+				OperandStack operands;
+
+				/** The values of the inputs of the formula being run */
+				std::vector<int> values;
+
+				/** The number of formulas run by the worker in the current recompute */
+				size_t recomputed = 0;
+			};
+
+			/** The pool large waves are run with */
+			ThreadPool* pool;
+
+			/** Compiles the formulas */
+			Evaluator evaluator;
+
+			/** The nodes. Indices never change. */
+			std::vector<Node> nodes;
+
+			/** The index of each node by name */
+			std::unordered_map<std::string, size_t> index;
+
+			/** The nodes set or defined since the last recompute */
+			std::vector<size_t> pending;
+
+			/** The scratch space of each worker of #pool */
+			std::vector<Scratch> scratch;
+
+			/** The nodes downstream of a change in the current recompute */
+			std::vector<size_t> affected;
+
+			/** The nodes of the wave being run, and of the wave after it */
+			std::vector<size_t> wave;
+			std::vector<size_t> next_wave;
+
+			/** Incremented for each traversal of the graph, so nodes can be marked visited without clearing a set */
+			uint64_t epoch = 0;
+
+			/** The number of formulas run by the last recompute */
+			size_t recomputed_count = 0;
+
+			/**
+			 * @brief Get the node called @p name, adding an input with the value 0 if there is none.
+			 * @param[in] name The name of the node.
+			 * @return The index of the node.
+			 */
+			size_t find_or_add(const std::string& name);
+
+			/**
+			 * @brief Get the node called @p name.
+			 * @param[in] name The name of the node.
+			 * @return The node.
+			 * @throws FormulaGraphException When there is no node called @p name.
+			 */
+			const Node& find(const std::string& name) const;
+
+			/**
+			 * @brief Removes @p node from the dependents of its inputs, and clears its inputs.
+			 * @param[in] node The index of the node.
+			 */
+			void unlink(size_t node);
+
+			/**
+			 * @brief Finds a way from any of @p inputs back to @p node through the inputs of the nodes along it.
+			 * @param[in] node The index of the node being defined.
+			 * @param[in] inputs The indices of the nodes the new formula of @p node would have as inputs.
+			 * @return The cycle the new formula would create, as the names along it. Empty if there is none.
+			 */
+			std::string find_cycle(size_t node, const std::vector<size_t>& inputs);
+
+			/**
+			 * @brief Recomputes @p node once all of its inputs have been.
+			 * @param[in] node The index of the node.
+			 * @param[in,out] scratch The scratch space of the calling worker.
+			 */
+			void run(size_t node, Scratch& scratch);
+	};
+}
@@ -1,26 +1,120 @@
 #pragma once
 
 // STD
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <stack>
+#include <string_view>
+
+// InfixParser
+#include <InfixParser/Stack.hpp>
+
+// __int128 is a GCC and Clang extension
+#if defined(__SIZEOF_INT128__)
+	#define INFIXPARSER_INT128
+#endif
 
 namespace InfixParser {
-	/** The operand stack type. */
-	using OperandStack = std::stack<int>;
+	/**
+	 * @brief The operand stack type for values of type @p T. Expressions up to 64 operands deep never allocate.
+	 * @tparam T The type of the values. One of int, int64_t, __int128 or double.
+	 */
+	template<class T>
+	using BasicOperandStack = Stack<T, 64>;
+
+	/** The operand stack type. Expressions up to 64 operands deep never allocate. */
+	using OperandStack = BasicOperandStack<int>;
+
+	/**
+	 * @brief The character classes the lexer is driven by. Constant, so the lexer can be used by eval() in constant expressions.
+	 */
+	namespace Lexer {
+		/** The classes a character can belong to */
+		enum Class : uint8_t {
+			WHITESPACE = 1 << 0,
+			DIGIT = 1 << 1,
+			LETTER = 1 << 2,
+		};
+
+		/** The classes of each character */
+		inline constexpr auto classes = []{
+			std::array<uint8_t, 256> classes = {};
+
+			classes[' '] = WHITESPACE;
+			classes['\t'] = WHITESPACE;
+			classes['_'] = LETTER;
+
+			for (auto c = '0'; c <= '9'; ++c) { classes[static_cast<unsigned char>(c)] = DIGIT; }
+			for (auto c = 'a'; c <= 'z'; ++c) { classes[static_cast<unsigned char>(c)] = LETTER; }
+			for (auto c = 'A'; c <= 'Z'; ++c) { classes[static_cast<unsigned char>(c)] = LETTER; }
+
+			return classes;
+		}();
+
+		/**
+		 * @brief Checks if @p value belongs to any of the classes in @p mask.
+		 */
+		constexpr bool has_class(char value, uint8_t mask) {
+			return (classes[static_cast<unsigned char>(value)] & mask) != 0;
+		}
+	}
 
 	/**
 	 * @brief Checks if @p value is a number.
 	 * @param[in] value The value to check.
 	 * @return True if @p value is a number, false otherwise.
 	 */
-	bool is_number(char value);
+	constexpr bool is_number(char value) {
+		return Lexer::has_class(value, Lexer::DIGIT);
+	}
 
 	/**
 	 * @brief Checks if @p value is a whitespace character.
 	 * @param[in] value The value to check.
 	 * @return True if @p value is a whitespace character, false otherwise.
 	 */
-	bool is_whitespace(char value);
+	constexpr bool is_whitespace(char value) {
+		return Lexer::has_class(value, Lexer::WHITESPACE);
+	}
+
+	/**
+	 * @brief Checks if @p value can start an identifier.
+	 * @param[in] value The value to check.
+	 * @return True if @p value is a letter or an underscore, false otherwise.
+	 */
+	constexpr bool is_identifier_start(char value) {
+		return Lexer::has_class(value, Lexer::LETTER);
+	}
+
+	/**
+	 * @brief Checks if @p value can be part of an identifier.
+	 * @param[in] value The value to check.
+	 * @return True if @p value is a letter, number or an underscore, false otherwise.
+	 */
+	constexpr bool is_identifier(char value) {
+		return Lexer::has_class(value, Lexer::LETTER | Lexer::DIGIT);
+	}
+
+	/**
+	 * @brief Finds the end of the run of whitespace characters at the start of the string defined by @p begin, and @p end.
+	 * Long runs are scanned sixteen characters at a time when SSE2 is available.
+	 *
+	 * @param[in] begin The beginning of the string.
+	 * @param[in] end The end of the string.
+	 * @return One past the last whitespace character of the run.
+	 */
+	const char* skip_whitespace(const char* begin, const char* end);
+
+	/**
+	 * @brief Finds the end of the run of number characters at the start of the string defined by @p begin, and @p end.
+	 * Long runs are scanned sixteen characters at a time when SSE2 is available.
+	 *
+	 * @param[in] begin The beginning of the string.
+	 * @param[in] end The end of the string.
+	 * @return One past the last number character of the run.
+	 */
+	const char* skip_number(const char* begin, const char* end);
 
 	/**
 	 * @brief Reads the first number from the string defined by @p begin, and @p end.
@@ -28,6 +122,29 @@ namespace InfixParser {
 	 *
 	 * @param[in,out] begin The beginning of the string.
 	 * @param[in] end The end of the string.
+	 * @param[out] value The number that was read.
+	 * @return False if the number is too large to be stored in a @p T, true otherwise.
+	 * @tparam T The type of the number. One of int, int64_t, __int128 or double.
 	 */
-	int read_number(std::string::const_iterator& begin, std::string::const_iterator end);
+	template<class T>
+	bool read_number(const char*& begin, const char* end, T& value);
+
+	/**
+	 * @brief Reads the first identifier from the string defined by @p begin, and @p end.
+	 * After this function is called @p begin points to one past the end of the identifier.
+	 *
+	 * @param[in,out] begin The beginning of the string.
+	 * @param[in] end The end of the string.
+	 */
+	constexpr std::string_view read_identifier(const char*& begin, const char* end) {
+		auto start = begin;
+
+		// Read until the first non-identifier character
+		while (begin != end) {
+			if (!is_identifier(*begin)) { break; }
+			++begin;
+		}
+
+		return std::string_view(start, static_cast<size_t>(begin - start));
+	}
 }
@@ -0,0 +1,73 @@
+#pragma once
+
+// STD
+#include <cstddef>
+
+// InfixParser
+#include <InfixParser/Operator.hpp>
+
+/**
+ * @brief Vectorized implementations of the predefined operators and built-in functions used by batch evaluation.
+ *
+ * Each kernel applies an Operator to a whole block of rows at once.
+ * AVX2 is used when the compiler targets it, SSE otherwise on x86-64, and plain loops everywhere else.
+ * The checked operators are always plain loops, since they stop at the first row that overflows.
+ */
+namespace InfixParser::Kernels {
+	/**
+	 * @brief Applies a unary Operator to each of the @p count values in @p values.
+	 * @param[in,out] values The operands to apply the Operator to. Overwritten with the results.
+	 * @param[in] count The number of values.
+	 * @return The index of the first value the Operator could not be applied to, or @p count if it applied to all values.
+	 *         Values from that index onwards are left unchanged.
+	 */
+	using UnaryKernel = size_t(*)(int* values, size_t count);
+
+	/**
+	 * @brief Applies a binary Operator to each pair in @p left and @p right.
+	 * @param[in,out] left The left operands. Overwritten with the results.
+	 * @param[in] right The right operands.
+	 * @param[in] count The number of values.
+	 * @return The index of the first row the Operator could not be applied to, or @p count if it applied to all rows.
+	 *         Rows from that index onwards are left unchanged.
+	 */
+	using BinaryKernel = size_t(*)(int* left, const int* right, size_t count);
+
+	/**
+	 * @brief Applies a ternary Operator to each triple in @p first, @p second and @p third.
+	 * @param[in,out] first The first operands. Overwritten with the results.
+	 * @param[in] second The second operands.
+	 * @param[in] third The third operands.
+	 * @param[in] count The number of values.
+	 * @return The index of the first row the Operator could not be applied to, or @p count if it applied to all rows.
+	 *         Rows from that index onwards are left unchanged.
+	 */
+	using TernaryKernel = size_t(*)(int* first, const int* second, const int* third, size_t count);
+
+	/**
+	 * @brief The kernels for a single Operator. At most one of the members is set.
+	 */
+	struct Kernel {
+		/** The kernel for a unary Operator. */
+		UnaryKernel unary = nullptr;
+
+		/** The kernel for a binary Operator. */
+		BinaryKernel binary = nullptr;
+
+		/** The kernel for a ternary Operator. */
+		TernaryKernel ternary = nullptr;
+	};
+
+	/**
+	 * @brief Get the kernel for @p op.
+	 * @param[in] op The Operator to get the kernel for.
+	 * @return The kernel for @p op. All members are nullptr if @p op has no kernel.
+	 */
+	Kernel find(const Operator* op);
+
+	/**
+	 * @brief Get the name of the instruction set the kernels were compiled for.
+	 * @return "AVX2", "SSE" or "Scalar".
+	 */
+	const char* instruction_set();
+}
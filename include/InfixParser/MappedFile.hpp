@@ -0,0 +1,65 @@
+#pragma once
+
+// STD
+#include <string>
+#include <stdexcept>
+
+namespace InfixParser {
+	class MappedFileException : public std::runtime_error {
+		using runtime_error::runtime_error;
+	};
+
+	/**
+	 * @brief A read-only view of a whole file mapped into memory.
+	 *
+	 * Example usage:
+	 * @code
+	 * MappedFile file{"equations.txt"};
+	 * std::string_view contents{file.data(), file.size()};
+	 * @endcode
+	 */
+	class MappedFile {
+		public:
+			/**
+			 * @brief Maps the file at @p path into memory.
+			 * @param[in] path The path of the file to map.
+			 * @throws MappedFileException When the file cannot be opened or mapped.
+			 */
+			explicit MappedFile(const std::string& path);
+
+			/**
+			 * @brief Unmaps the file.
+			 */
+			~MappedFile();
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			/**
+			 * @brief Get the contents of the file.
+			 * @return A pointer to the first byte of the file. nullptr if the file is empty.
+			 */
+			const char* data() const;
+
+			/**
+			 * @brief Get the size of the file.
+			 * @return The size of the file in bytes.
+			 */
+			size_t size() const;
+
+		private:
+			/** The first byte of the mapping */
+			const char* first = nullptr;
+
+			/** The size of the mapping */
+			size_t length = 0;
+
+		#if defined(INFIXPARSER_OS_WINDOWS)
+			/** The file handle */
+			void* file = nullptr;
+
+			/** The file mapping handle */
+			void* mapping = nullptr;
+		#endif
+	};
+}
@@ -1,46 +1,153 @@
 #pragma once
 
 // STD
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <stack>
 
 // InfixParser
 #include <InfixParser/InfixParser.hpp>
+#include <InfixParser/Error.hpp>
 
 namespace InfixParser {
-	class OperatorException : public std::runtime_error {
-		using runtime_error::runtime_error;
+	/**
+	 * @brief Identifies the grammar of each predefined operator. Checked operators are the same kind as the operators they check.
+	 * Operators added to a registry are all OperatorKind::REGISTERED.
+	 */
+	enum class OperatorKind : uint8_t {
+		REGISTERED,
+		ABS,
+		MIN,
+		MAX,
+		CLAMP,
+		NEGATE,
+		RIGHT_PAREN,
+		NOT,
+		PRE_INCREMENT,
+		PRE_DECREMENT,
+		POWER,
+		MULTIPLY,
+		DIVIDE,
+		REMAINDER,
+		ADD,
+		SUBTRACT,
+		GREATER,
+		GREATER_OR_EQUAL,
+		LESS,
+		LESS_OR_EQUAL,
+		EQUAL,
+		NOT_EQUAL,
+		AND,
+		OR,
+		LEFT_PAREN,
+		COMMA
 	};
 
+	/** The number of values of OperatorKind. */
+	inline constexpr size_t operator_kinds = static_cast<size_t>(OperatorKind::COMMA) + 1;
+
 	/**
-	 * @brief Represents an operator.
+	 * @brief The properties of an operator that do not depend on the type of its operands.
+	 * Literal, so the grammar can be used in constant expressions by eval().
+	 */
+	struct OperatorInfo {
+		/** The string representation of the operator. */
+		const char* token;
+
+		/** The precedence of the operator. */
+		int precedence;
+
+		/** The associativity of the operator. */
+		bool right_associative;
+
+		/** The number of operands the operator consumes. */
+		int arity;
+
+		/** The predefined operator this is the grammar of. */
+		OperatorKind kind;
+	};
+
+	/**
+	 * @brief The grammar of every predefined operator. Shared by the operators of each value type, and their checked versions.
+	 *
+	 * The built-in functions are called as name(arguments...), with the arguments separated by COMMA. They bind tighter than
+	 * any operator, so they are applied as soon as the ) of their call is read.
+	 */
+	namespace Grammar {
+		inline constexpr OperatorInfo ABS = {"abs", 11, true, 1, OperatorKind::ABS};
+		inline constexpr OperatorInfo MIN = {"min", 11, true, 2, OperatorKind::MIN};
+		inline constexpr OperatorInfo MAX = {"max", 11, true, 2, OperatorKind::MAX};
+		inline constexpr OperatorInfo CLAMP = {"clamp", 11, true, 3, OperatorKind::CLAMP};
+		inline constexpr OperatorInfo NEGATE = {"N", 10, true, 1, OperatorKind::NEGATE};
+		inline constexpr OperatorInfo RIGHT_PAREN = {")", 9, false, 0, OperatorKind::RIGHT_PAREN};
+		inline constexpr OperatorInfo NOT = {"!", 8, true, 1, OperatorKind::NOT};
+		inline constexpr OperatorInfo PRE_INCREMENT = {"++", 8, true, 1, OperatorKind::PRE_INCREMENT};
+		inline constexpr OperatorInfo PRE_DECREMENT = {"--", 8, true, 1, OperatorKind::PRE_DECREMENT};
+		inline constexpr OperatorInfo POWER = {"^", 7, false, 2, OperatorKind::POWER};
+		inline constexpr OperatorInfo MULTIPLY = {"*", 6, false, 2, OperatorKind::MULTIPLY};
+		inline constexpr OperatorInfo DIVIDE = {"/", 6, false, 2, OperatorKind::DIVIDE};
+		inline constexpr OperatorInfo REMAINDER = {"%", 6, false, 2, OperatorKind::REMAINDER};
+		inline constexpr OperatorInfo ADD = {"+", 5, false, 2, OperatorKind::ADD};
+		inline constexpr OperatorInfo SUBTRACT = {"-", 5, false, 2, OperatorKind::SUBTRACT};
+		inline constexpr OperatorInfo GREATER = {">", 4, false, 2, OperatorKind::GREATER};
+		inline constexpr OperatorInfo GREATER_OR_EQUAL = {">=", 4, false, 2, OperatorKind::GREATER_OR_EQUAL};
+		inline constexpr OperatorInfo LESS = {"<", 4, false, 2, OperatorKind::LESS};
+		inline constexpr OperatorInfo LESS_OR_EQUAL = {"<=", 4, false, 2, OperatorKind::LESS_OR_EQUAL};
+		inline constexpr OperatorInfo EQUAL = {"==", 3, false, 2, OperatorKind::EQUAL};
+		inline constexpr OperatorInfo NOT_EQUAL = {"!=", 3, false, 2, OperatorKind::NOT_EQUAL};
+		inline constexpr OperatorInfo AND = {"&&", 2, false, 2, OperatorKind::AND};
+		inline constexpr OperatorInfo OR = {"||", 1, false, 2, OperatorKind::OR};
+		inline constexpr OperatorInfo LEFT_PAREN = {"(", 0, true, 0, OperatorKind::LEFT_PAREN};
+		inline constexpr OperatorInfo COMMA = {",", 0, false, 0, OperatorKind::COMMA};
+	}
+
+	/**
+	 * @brief Represents an operator on values of type @p T.
+	 * Each value type has its own set of predefined operators, so applying one never dispatches on the type at runtime.
 	 *
 	 * Example usage: 
 	 * @code
-	 * const Operator Operator::ADD = {"+", 5, false, [](OperandStack& operands) {
-	 *		if (operands.size() < 2) { throw OperatorException{"Operator + (ADD) requires at least two operands."}; }
+	 * template<class T>
+	 * const BasicOperator<T> BasicOperator<T>::ADD = {Grammar::ADD, [](BasicOperandStack<T>& operands) {
+	 *		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 	 *	
 	 *		auto right = operands.top();
 	 *		operands.pop();
 	 *	
 	 *		auto& left = operands.top();
 	 *		left = left + right;
+	 *
+	 *		return Error::NONE;
 	 * }};
 	 * @endcode
+	 *
+	 * @tparam T The type of the operands. One of int, int64_t, __int128 or double.
 	 */
-	class Operator {
+	template<class T>
+	class BasicOperator {
 		public:
-			/** The type of the funciton called when an Operator is applied. */
-			using OperatorFunction = void(*)(OperandStack&);
+			/**
+			 * The type of the funciton called when an Operator is applied. The operands are stored contiguously in the OperandStack.
+			 * Returns Error::NONE on success. On failure the operands may be left in any state.
+			 */
+			using OperatorFunction = Error(*)(BasicOperandStack<T>&);
 
 			/**
-			 * @brief Create an Operator with a given string representation, precedence, associativity, and function.
+			 * @brief Create an Operator with a given string representation, precedence, associativity, arity, and function.
 			 * @param[in] as_string The string representation of the Operator.
 			 * @param[in] precedence The precedence of the Operator.
 			 * @param[in] right_associative Sets the Operator to be right associative.
+			 * @param[in] arity The number of operands the Operator consumes.
 			 * @param[in] function The function to call when this operator is applied.
 			 */
-			Operator(std::string as_string, int precedence, bool right_associative, OperatorFunction function);
+			BasicOperator(std::string as_string, int precedence, bool right_associative, int arity, OperatorFunction function);
+
+			/**
+			 * @brief Create an Operator with the grammar @p info and a function.
+			 * @param[in] info The string representation, precedence, associativity and arity of the Operator.
+			 * @param[in] function The function to call when this operator is applied.
+			 */
+			BasicOperator(const OperatorInfo& info, OperatorFunction function);
 
 			/**
 			 * @brief Get the string representation of this Operator.
@@ -60,11 +167,24 @@ namespace InfixParser {
 			 */
 			bool is_right_associative() const;
 
+			/**
+			 * @brief Get the number of operands this Operator consumes.
+			 * @return The number of operands this Operator consumes.
+			 */
+			int arity() const;
+
+			/**
+			 * @brief Get the predefined operator this Operator is, or checks. OperatorKind::REGISTERED for any other Operator.
+			 * @return The kind of this Operator.
+			 */
+			OperatorKind kind() const;
+
 			/**
 			 * @brief Applies this Operator to the operand stack @p operands.
 			 * @param[in,out] operands The operands to apply this Operator to.
+			 * @return Error::NONE on success, otherwise why this Operator could not be applied.
 			 */
-			void apply(OperandStack& operands) const;
+			Error apply(BasicOperandStack<T>& operands) const;
 
 		private:
 			/** The string representation of this operator */ 
@@ -76,30 +196,66 @@ namespace InfixParser {
 			/** The associativity of this operator */
 			const bool right_associative;
 
+			/** The number of operands this operator consumes */
+			const int arity_value;
+
+			/** The predefined operator this operator is, or checks */
+			const OperatorKind kind_value;
+
 			/** The function that is called when this operator is applied */
 			const OperatorFunction function;
 		
 		// Predefined operators
 		public:
-			static const Operator NEGATE;
-			static const Operator RIGHT_PAREN;
-			static const Operator NOT;
-			static const Operator PRE_INCREMENT;
-			static const Operator PRE_DECREMENT;
-			static const Operator POWER;
-			static const Operator MULTIPLY;
-			static const Operator DIVIDE;
-			static const Operator REMAINDER;
-			static const Operator ADD;
-			static const Operator SUBTRACT;
-			static const Operator GREATER;
-			static const Operator GREATER_OR_EQUAL;
-			static const Operator LESS;
-			static const Operator LESS_OR_EQUAL;
-			static const Operator EQUAL;
-			static const Operator NOT_EQUAL;
-			static const Operator AND;
-			static const Operator OR;
-			static const Operator LEFT_PAREN;
+			static const BasicOperator NEGATE;
+			static const BasicOperator RIGHT_PAREN;
+			static const BasicOperator NOT;
+			static const BasicOperator PRE_INCREMENT;
+			static const BasicOperator PRE_DECREMENT;
+			static const BasicOperator POWER;
+			static const BasicOperator MULTIPLY;
+			static const BasicOperator DIVIDE;
+			static const BasicOperator REMAINDER;
+			static const BasicOperator ADD;
+			static const BasicOperator SUBTRACT;
+			static const BasicOperator GREATER;
+			static const BasicOperator GREATER_OR_EQUAL;
+			static const BasicOperator LESS;
+			static const BasicOperator LESS_OR_EQUAL;
+			static const BasicOperator EQUAL;
+			static const BasicOperator NOT_EQUAL;
+			static const BasicOperator AND;
+			static const BasicOperator OR;
+			static const BasicOperator LEFT_PAREN;
+			static const BasicOperator COMMA;
+
+		// Built-in functions
+		public:
+			static const BasicOperator ABS;
+			static const BasicOperator MIN;
+			static const BasicOperator MAX;
+			static const BasicOperator CLAMP;
+
+		// Predefined operators that report Error::INTEGER_OVERFLOW instead of wrapping. The same as the unchecked operators for double.
+		public:
+			static const BasicOperator CHECKED_NEGATE;
+			static const BasicOperator CHECKED_PRE_INCREMENT;
+			static const BasicOperator CHECKED_PRE_DECREMENT;
+			static const BasicOperator CHECKED_POWER;
+			static const BasicOperator CHECKED_MULTIPLY;
+			static const BasicOperator CHECKED_DIVIDE;
+			static const BasicOperator CHECKED_ADD;
+			static const BasicOperator CHECKED_SUBTRACT;
+			static const BasicOperator CHECKED_ABS;
 	};
+
+	/** An operator on ints. */
+	using Operator = BasicOperator<int>;
+
+	extern template class BasicOperator<int>;
+	extern template class BasicOperator<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	extern template class BasicOperator<__int128>;
+#endif
+	extern template class BasicOperator<double>;
 }
\ No newline at end of file
@@ -0,0 +1,223 @@
+#pragma once
+
+// STD
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// InfixParser
+#include <InfixParser/Operator.hpp>
+
+namespace InfixParser {
+	class OperatorRegistryException : public std::runtime_error {
+		using runtime_error::runtime_error;
+	};
+
+	/**
+	 * @brief The operators an evaluator recognizes, looked up by their symbol.
+	 *
+	 * Operators are registered at startup, then the registry is frozen into a prefix trie. Evaluators read the longest
+	 * registered symbol at each operator token, so registering << does not change how < is read.
+	 *
+	 * A symbol can have two operators. Its prefix operator, which is unary and right associative, is used where an operand is expected.
+	 * Its infix operator is used after an operand. This is how - is both negation and subtraction. When a symbol only has one of them,
+	 * it is used in both places.
+	 *
+	 * Example usage:
+	 * @code
+	 * OperatorRegistry registry;
+	 * registry.add("<<", 5, false, 2, [](OperandStack& operands) { ... });
+	 * registry.freeze();
+	 *
+	 * Evaluator evaluator{registry};
+	 * auto result = evaluator.evaluate("1 << 4");
+	 * @endcode
+	 *
+	 * Registered operators are applied through their function, which must not depend on anything but its operands.
+	 * They are folded when their operands are constant, and batches apply them one row at a time.
+	 * A registry must outlive the evaluators that use it and the expressions they compile.
+	 *
+	 * @tparam T The type of the operands. One of int, int64_t, __int128 or double.
+	 */
+	template<class T>
+	class BasicOperatorRegistry {
+		public:
+			/**
+			 * @brief Constructs a registry of the predefined operators that can be extended until it is frozen.
+			 */
+			BasicOperatorRegistry();
+
+			BasicOperatorRegistry(const BasicOperatorRegistry&) = delete;
+			BasicOperatorRegistry& operator=(const BasicOperatorRegistry&) = delete;
+
+			/**
+			 * @brief Creates and registers an operator.
+			 * @param[in] symbol The symbol of the operator. Must not contain letters, numbers, underscores or whitespace.
+			 * @param[in] precedence The precedence of the operator. At least 1, since 0 is reserved for ( and ,. The predefined operators use 1 to 11, see Grammar.
+			 * @param[in] right_associative Sets the operator to be right associative.
+			 * @param[in] arity The number of operands the operator consumes. One of 1, 2 or 3.
+			 * @param[in] function The function to call when the operator is applied.
+			 * @return The operator, owned by this registry.
+			 * @throws OperatorRegistryException When this registry is frozen, @p symbol is invalid, @p symbol already has an operator in the same position,
+			 *         or @p precedence or @p arity is out of range.
+			 */
+			const BasicOperator<T>& add(std::string symbol, int precedence, bool right_associative, int arity, typename BasicOperator<T>::OperatorFunction function);
+
+			/**
+			 * @brief Registers an existing operator under @p symbol.
+			 * @param[in] symbol The symbol of the operator. Must not contain letters, numbers, underscores or whitespace.
+			 * @param[in] op The operator. Must outlive this registry.
+			 * @throws OperatorRegistryException When this registry is frozen, @p symbol is invalid or @p symbol already has an operator in the same position.
+			 */
+			void add(std::string_view symbol, const BasicOperator<T>& op);
+
+			/**
+			 * @brief Builds the lookup trie. No operators can be registered afterwards.
+			 */
+			void freeze();
+
+			/**
+			 * @brief Checks if this registry is frozen.
+			 * @return True if operators can be looked up, false if operators can still be registered.
+			 */
+			bool is_frozen() const;
+
+			/**
+			 * @brief Reads the longest registered symbol at the start of the string defined by @p begin, and @p end.
+			 * After this function is called @p begin points to one past the end of the symbol, or one past @p begin when no symbol matches.
+			 *
+			 * @param[in,out] begin The beginning of the string. Must not be @p end.
+			 * @param[in] end The end of the string.
+			 * @param[in] prefix True if an operand is expected, so the prefix operator of the symbol is preferred.
+			 * @return The operator the symbol represents. nullptr if no registered symbol matches.
+			 */
+			const BasicOperator<T>* match(const char*& begin, const char* end, bool prefix) const {
+				// Single character symbols are found without leaving the root table
+				const auto& root = roots[static_cast<unsigned char>(*begin)];
+				const auto* found = root.node.operators[prefix];
+				++begin;
+
+				if (begin == end) {
+					return found;
+				}
+
+				// So are the two character symbols whose first character starts no other symbol, such as && or <=
+				if (*begin == root.leaf.label && root.leaf.operators[0] != nullptr) {
+					++begin;
+					return root.leaf.operators[prefix];
+				}
+
+				const auto* node = &root.node;
+
+				if (node->child_count == 0) {
+					return found;
+				}
+
+				// Walk down the trie, remembering the last node that has an operator
+				// Kept local since the symbol's characters may alias the nodes
+				const auto* children = nodes.data();
+				const auto* current = begin;
+				const auto* found_end = begin;
+
+				while (node->child_count != 0 && current != end) {
+					const auto* child = children + node->first_child;
+					const auto* last = child + node->child_count;
+					const auto c = *current;
+
+					while (child != last && child->label != c) { ++child; }
+					if (child == last) { break; }
+
+					node = child;
+					++current;
+
+					if (const auto op = node->operators[prefix]; op != nullptr) {
+						found = op;
+						found_end = current;
+					}
+				}
+
+				begin = found_end;
+				return found;
+			}
+
+			/**
+			 * @brief Get the frozen registry of the predefined operators, used by evaluators constructed without a registry.
+			 * @return The registry of the predefined operators.
+			 */
+			static const BasicOperatorRegistry& predefined();
+
+		private:
+			/** A symbol and its operators */
+			struct Entry {
+				std::string symbol;
+				const BasicOperator<T>* infix = nullptr;
+				const BasicOperator<T>* prefix = nullptr;
+			};
+
+			/** A node of the trie. The children of a node are stored contiguously. */
+			struct Node {
+				/**
+				 * The operator used after an operand, then the one used where an operand is expected, so match() indexes by its prefix flag.
+				 * Each falls back to the other when the symbol has only one operator.
+				 */
+				std::array<const BasicOperator<T>*, 2> operators = {};
+
+				/** The index of the first child */
+				uint32_t first_child = 0;
+
+				/** The number of children */
+				uint16_t child_count = 0;
+
+				/** The character that leads to this node from its parent */
+				char label = '\0';
+			};
+
+			/** The operators created by this registry. A deque so that they never move. */
+			std::deque<BasicOperator<T>> owned;
+
+			/** The registered symbols */
+			std::vector<Entry> entries;
+
+			/** The node of a first character, with its only child when that child is a leaf, so match() need not read #nodes */
+			struct Root {
+				/** The node of the first character. Empty if no symbol starts with it. Has no children when its child is #leaf. */
+				Node node;
+
+				/** The only child of #node if it has no children of its own, otherwise empty */
+				Node leaf;
+			};
+
+			/** The root for each first character */
+			std::array<Root, 256> roots = {};
+
+			/** The nodes of the trie below the roots */
+			std::vector<Node> nodes;
+
+			/** True once the trie has been built */
+			bool frozen = false;
+
+			/**
+			 * @brief Adds the children of a node, and their descendants, to #nodes.
+			 * @param[in] begin The first of the sorted entries that start with the symbol of the node.
+			 * @param[in] end One past the last of the sorted entries that start with the symbol of the node.
+			 * @param[in] depth The length of the symbol of the node.
+			 * @return The index of the first child and the number of children.
+			 */
+			std::pair<uint32_t, uint32_t> build(size_t begin, size_t end, size_t depth);
+	};
+
+	/** The operators on ints an evaluator recognizes. */
+	using OperatorRegistry = BasicOperatorRegistry<int>;
+
+	extern template class BasicOperatorRegistry<int>;
+	extern template class BasicOperatorRegistry<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	extern template class BasicOperatorRegistry<__int128>;
+#endif
+	extern template class BasicOperatorRegistry<double>;
+}
@@ -0,0 +1,413 @@
+#pragma once
+
+// STD
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+// InfixParser
+#include <InfixParser/InfixParser.hpp>
+#include <InfixParser/Error.hpp>
+#include <InfixParser/Operator.hpp>
+#include <InfixParser/CompiledExpression.hpp>
+
+namespace InfixParser {
+	/**
+	 * @brief Converts infix equations into postfix instructions with the shunting-yard algorithm.
+	 *
+	 * The conversion shared by BasicEvaluator at runtime and by eval() in constant expressions, so an equation is read the same way,
+	 * and fails with the same error, on both paths. Every member is constexpr. @p Derived supplies the parts that differ:
+	 * - `Op match(const char*& begin, const char* end, bool prefix)` reads an operator token, the same as BasicOperatorRegistry::match.
+	 * - `static const char* skip_whitespace(const char* begin, const char* end)` and
+	 *   `static bool read_number(const char*& begin, const char* end, T& value)` read whitespace and numbers.
+	 * - `Op find_function(std::string_view name)` and `bool resolve(std::string_view name, int& slot)` look up names.
+	 * - `static OperatorKind kind(Op)`, `precedence(Op)`, `is_right_associative(Op)` and `arity(Op)` describe an operator.
+	 * - `void begin_program()`, `void emit_operand(Type type, T value)`, `void emit_operator(Op op, size_t arity, size_t jump)` and
+	 *   `size_t emit_jump(Type type)` write the instructions.
+	 * - `void lexed_token()` is called for each number, name and operator token read, and
+	 *   `void pushed_operator()` whenever an operator is pushed onto #operators.
+	 *
+	 * @tparam Derived The class that converts equations. Must befriend this class.
+	 * @tparam T The type of the values.
+	 * @tparam Op The type that identifies an operator. Op{} is no operator.
+	 * @tparam StackType The stack used for operators, jumps and calls, such as Stack.
+	 * @tparam Capacity The second argument of @p StackType.
+	 */
+	template<class Derived, class T, class Op, template<class, size_t> class StackType, size_t Capacity>
+	class ShuntingYard {
+		protected:
+			/** The type of an instruction */
+			using Type = typename BasicInstruction<T>::Type;
+
+			/** Passed to emit_operator() for operators without a jump to complete */
+			static constexpr size_t no_jump = ~size_t{0};
+
+			/** Stores all active operators */
+			StackType<Op, Capacity> operators;
+
+			/** The indices of the jumps emitted for the && and || operators that have not been emitted yet */
+			StackType<size_t, Capacity> jumps;
+
+			/** A call of a built-in function whose function has not been emitted yet */
+			struct Call {
+				/** The index of the function in #operators. Its ( follows it. */
+				size_t function = 0;
+
+				/** The value of #stack_depth before the arguments of the call */
+				size_t stack_depth = 0;
+			};
+
+			/** The calls being parsed, innermost last */
+			StackType<Call, Capacity> calls;
+
+			/** The beginning of the equation being converted */
+			const char* equation_begin = nullptr;
+
+			/** The position of the token currently being handled */
+			size_t position = 0;
+
+			/** The number of operands on the stack after the emitted instructions have run */
+			size_t stack_depth = 0;
+
+			/** The largest value of stack_depth seen so far */
+			size_t max_stack_depth = 0;
+
+			/** The current operator depth */
+			int operator_depth = 1;
+
+			/** True if an operand is expected. Used only for error reporting. */
+			bool expect_operand = true;
+
+			/** The position of the last error returned by build() */
+			size_t error_position = 0;
+
+			/** The operator the last error returned by build() occurred in, if any */
+			Op error_operator = {};
+
+			/**
+			 * @brief Converts @p equation into postfix instructions.
+			 * On failure #error_position and #error_operator describe where the error occurred.
+			 * @param[in] equation The equation to convert.
+			 * @return Error::NONE, or the reason @p equation is ill formed.
+			 */
+			constexpr Error build(std::string_view equation) {
+				error_position = 0;
+				error_operator = Op{};
+
+				// Ensure we have a non-empty equation
+				if (equation.empty()) {
+					return Error::EMPTY_EQUATION;
+				}
+
+				// Ensure our state is empty without releasing any memory
+				operators.clear();
+				jumps.clear();
+				calls.clear();
+				operator_depth = 1;
+				expect_operand = true;
+				stack_depth = 0;
+				max_stack_depth = 0;
+				derived().begin_program();
+
+				// Get some useful pointers
+				auto begin = equation.data();
+				auto current = begin;
+				auto end = begin + equation.size();
+				equation_begin = begin;
+
+				// Errors are reported at the last character read
+				const auto fail = [&](Error error) {
+					error_position = static_cast<size_t>(current - begin - 1);
+					return error;
+				};
+
+				// Parse the string
+				while (current != end) {
+					// Ignore whitespaces
+					if (is_whitespace(*current)) {
+						current = Derived::skip_whitespace(current, end);
+						continue;
+					}
+
+					// Handle numbers, variables and tokens
+					if (is_number(*current) || is_identifier_start(*current)) {
+						if (operator_depth > 0) {
+							position = static_cast<size_t>(current - begin);
+							derived().lexed_token();
+
+							if (is_number(*current)) {
+								T value = 0;
+
+								if (!Derived::read_number(current, end, value)) {
+									return fail(Error::NUMBER_TOO_LARGE);
+								}
+
+								emit(Type::VALUE, value);
+							} else {
+								const auto name = read_identifier(current, end);
+								const auto next = Derived::skip_whitespace(current, end);
+
+								// A built-in function is called when its name is followed by (, otherwise the name is a variable
+								if (const auto function = derived().find_function(name); function != Op{} && next != end && *next == '(') {
+									operators.push(function);
+									calls.push({operators.size() - 1, stack_depth});
+									derived().pushed_operator();
+									continue;
+								}
+
+								int slot = 0;
+
+								if (!derived().resolve(name, slot)) {
+									return fail(Error::UNKNOWN_VARIABLE);
+								}
+
+								emit(Type::VARIABLE, static_cast<T>(slot));
+							}
+
+							operator_depth = 0;
+						} else {
+							return fail(Error::EXPECTED_OPERATOR);
+						}
+
+						expect_operand = false;
+					} else if (const auto error = handle_token(current, end); error != Error::NONE) {
+						return fail(error);
+					}
+				}
+
+				// Emit any remaining operators
+				position = static_cast<size_t>(current - begin - 1);
+				while (!operators.empty()) {
+					if (const auto error = emit(operators.top()); error != Error::NONE) {
+						return fail(error);
+					}
+
+					operators.pop();
+				}
+
+				if (expect_operand) {
+					return fail(Error::EXPECTED_FINAL_OPERAND);
+				}
+
+				// Ensure that all operands have been used
+				if (stack_depth != 1) {
+					return fail(Error::TOO_MANY_OPERANDS);
+				}
+
+				return Error::NONE;
+			}
+
+		private:
+			/**
+			 * @brief Get the class converting equations.
+			 * @return This object as a @p Derived.
+			 */
+			constexpr Derived& derived() {
+				return static_cast<Derived&>(*this);
+			}
+
+			/**
+			 * @brief Checks if @p kind is a built-in function.
+			 * @param[in] kind The kind of operator.
+			 * @return True if @p kind is called as name(arguments...), false otherwise.
+			 */
+			static constexpr bool is_function(OperatorKind kind) {
+				return kind == OperatorKind::ABS || kind == OperatorKind::MIN || kind == OperatorKind::MAX || kind == OperatorKind::CLAMP;
+			}
+
+			/**
+			 * @brief Handles every operator token at the start of the string defined by @p begin, and @p end.
+			 * @param[in,out] begin The beginning of the string. Moved past the tokens handled.
+			 * @param[in] end The end of the string.
+			 * @return Error::NONE, or the reason a token cannot appear where it does.
+			 */
+			constexpr Error handle_token(const char*& begin, const char* end) {
+				// Handle every consecutive operator token without growing the call stack
+				while (begin != end) {
+					// Ensure we are dealing with a token
+					if (is_whitespace(*begin)) { return Error::NONE; }
+					if (is_number(*begin)) { return Error::NONE; }
+					if (is_identifier_start(*begin)) { return Error::NONE; }
+
+					derived().lexed_token();
+
+					// Translate from a token to an operator. A token that does not follow an operand is a prefix operator, so - is a negation.
+					const auto op = derived().match(begin, end, operator_depth != 0);
+					position = static_cast<size_t>(begin - equation_begin - 1);
+
+					if (op == Op{}) {
+						return Error::UNKNOWN_OPERATOR;
+					}
+
+					// Handle the operator
+					if (const auto error = handle_operator(op); error != Error::NONE) {
+						return error;
+					}
+
+					derived().pushed_operator();
+				}
+
+				return Error::NONE;
+			}
+
+			/**
+			 * @brief Handles the processing of @p op.
+			 * @param[in] op The operator to handle.
+			 * @return Error::NONE, or the reason @p op cannot appear where it does.
+			 */
+			constexpr Error handle_operator(Op op) {
+				// Get useful information about the operator
+				const auto kind = Derived::kind(op);
+				const auto is_right_associative = Derived::is_right_associative(op);
+				const auto precedence = Derived::precedence(op);
+
+				// Right associative binary operators, such as a registered **, follow their left operand
+				const auto is_prefix = is_right_associative && Derived::arity(op) != 2;
+
+				// Increase operator depth
+				++operator_depth;
+
+				// Store if we are expecting an operand in the future.
+				if (is_prefix) {
+					expect_operand = true;
+				}
+
+				// Handle left parentheses
+				if (kind == OperatorKind::LEFT_PAREN) {
+					operators.push(op);
+					return Error::NONE;
+				}
+
+				// Error if we were expecting an operand
+				if (!is_prefix && expect_operand) {
+					return Error::EXPECTED_OPERAND;
+				}
+
+				// Complete the argument before a comma, keeping the ( of the call open for the next argument
+				if (kind == OperatorKind::COMMA) {
+					while (!operators.empty() && Derived::kind(operators.top()) != OperatorKind::LEFT_PAREN) {
+						if (const auto error = emit(operators.top()); error != Error::NONE) {
+							return error;
+						}
+
+						operators.pop();
+					}
+
+					// The ( must be the one that directly follows the function of the innermost call
+					if (calls.empty() || calls.top().function + 2 != operators.size()) {
+						return Error::MISPLACED_COMMA;
+					}
+
+					expect_operand = true;
+					return Error::NONE;
+				}
+
+				// Handle right parentheses
+				if (kind == OperatorKind::RIGHT_PAREN) {
+					// Apply all operators until a left parenthesis is found
+					while (true) {
+						if (operators.empty()) {
+							return Error::EXTRANEOUS_PARENTHESIS;
+						}
+
+						if (Derived::kind(operators.top()) == OperatorKind::LEFT_PAREN) {
+							break;
+						}
+
+						if (const auto error = emit(operators.top()); error != Error::NONE) {
+							return error;
+						}
+
+						operators.pop();
+					}
+
+					// Remove the left parenthesis
+					operators.pop();
+
+					// The parenthesized group is an operand, so a - after it subtracts
+					operator_depth = 0;
+				}
+
+				// Handle all other operators
+				while (!operators.empty()) {
+					const auto top_precedence = Derived::precedence(operators.top());
+
+					// Prefix operators have no left operand to take from the operators before them
+					if ((precedence <= top_precedence && !is_right_associative) || (precedence < top_precedence && !is_prefix && is_right_associative)) {
+						if (const auto error = emit(operators.top()); error != Error::NONE) {
+							return error;
+						}
+
+						operators.pop();
+					} else {
+						break;
+					}
+				}
+
+				// The left side of && and || is complete, so its right side can be skipped from here
+				if (kind == OperatorKind::AND || kind == OperatorKind::OR) {
+					jumps.push(derived().emit_jump(kind == OperatorKind::AND ? Type::JUMP_IF_FALSE : Type::JUMP_IF_TRUE));
+				}
+
+				operators.push(op);
+				return Error::NONE;
+			}
+
+			/**
+			 * @brief Appends an instruction that pushes an operand.
+			 * @param[in] type The type of the instruction.
+			 * @param[in] value The value or variable slot to push.
+			 */
+			constexpr void emit(Type type, T value) {
+				derived().emit_operand(type, value);
+				max_stack_depth = std::max(max_stack_depth, ++stack_depth);
+			}
+
+			/**
+			 * @brief Appends an instruction that applies @p op.
+			 * @param[in] op The operator to apply.
+			 * @return Error::WRONG_ARGUMENT_COUNT when @p op is a function called with the wrong number of arguments,
+			 *         Error::MISSING_OPERANDS when there are not enough operands for @p op, Error::NONE otherwise.
+			 */
+			constexpr Error emit(Op op) {
+				const auto kind = Derived::kind(op);
+
+				// Parentheses only affect the order operators are emitted in
+				if (kind == OperatorKind::LEFT_PAREN || kind == OperatorKind::RIGHT_PAREN) {
+					return Error::NONE;
+				}
+
+				// Ensure the operator will have enough operands when it is run
+				const auto arity = static_cast<size_t>(Derived::arity(op));
+
+				// A function takes exactly the arguments of its call
+				if (is_function(kind)) {
+					const auto call = calls.top();
+					calls.pop();
+
+					if (stack_depth - call.stack_depth != arity) {
+						error_operator = op;
+						return Error::WRONG_ARGUMENT_COUNT;
+					}
+				}
+
+				if (stack_depth < arity) {
+					error_operator = op;
+					return Error::MISSING_OPERANDS;
+				}
+
+				stack_depth = stack_depth - arity + 1;
+
+				// The jump after the left side of && and || skips to this operator
+				auto jump = no_jump;
+
+				if (kind == OperatorKind::AND || kind == OperatorKind::OR) {
+					jump = jumps.top();
+					jumps.pop();
+				}
+
+				derived().emit_operator(op, arity, jump);
+				return Error::NONE;
+			}
+	};
+}
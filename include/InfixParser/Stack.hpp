@@ -0,0 +1,190 @@
+#pragma once
+
+// STD
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+namespace InfixParser {
+	/**
+	 * @brief A contiguous stack that stores up to @p N values inline and only moves to the heap when it grows larger.
+	 * Popping and clearing never release memory, so a reused Stack stops allocating once it has grown to its largest size.
+	 *
+	 * @tparam T The type of the values. Must be trivially copyable.
+	 * @tparam N The number of values stored inline.
+	 */
+	template<class T, size_t N>
+	class Stack {
+		public:
+			/** The type of the values in this Stack. */
+			using value_type = T;
+
+			/**
+			 * @brief Constructs an empty Stack.
+			 */
+			Stack() = default;
+
+			/**
+			 * @brief Constructs a copy of @p other.
+			 */
+			Stack(const Stack& other) {
+				*this = other;
+			}
+
+			/**
+			 * @brief Constructs a Stack by taking the contents of @p other.
+			 */
+			Stack(Stack&& other) noexcept {
+				*this = std::move(other);
+			}
+
+			/**
+			 * @brief Replaces the contents of this Stack with a copy of @p other.
+			 */
+			Stack& operator=(const Stack& other) {
+				if (this != &other) {
+					reserve(other.count);
+					std::copy(other.first, other.first + other.count, first);
+					count = other.count;
+				}
+
+				return *this;
+			}
+
+			/**
+			 * @brief Replaces the contents of this Stack with the contents of @p other.
+			 */
+			Stack& operator=(Stack&& other) noexcept {
+				if (this == &other) { return *this; }
+
+				if (other.heap) {
+					heap = std::move(other.heap);
+					first = heap.get();
+					capacity = other.capacity;
+				} else {
+					heap.reset();
+					first = storage;
+					capacity = N;
+					std::copy(other.first, other.first + other.count, first);
+				}
+
+				count = other.count;
+
+				other.first = other.storage;
+				other.capacity = N;
+				other.count = 0;
+
+				return *this;
+			}
+
+			/**
+			 * @brief Adds @p value to the top of this Stack.
+			 */
+			void push(const T& value) {
+				if (count == capacity) {
+					reserve(capacity * 2);
+				}
+
+				first[count++] = value;
+			}
+
+			/**
+			 * @brief Removes the top value of this Stack. This Stack must not be empty.
+			 */
+			void pop() {
+				--count;
+			}
+
+			/**
+			 * @brief Get the top value of this Stack. This Stack must not be empty.
+			 * @return The top value of this Stack.
+			 */
+			T& top() {
+				return first[count - 1];
+			}
+
+			/** @copydoc top() */
+			const T& top() const {
+				return first[count - 1];
+			}
+
+			/**
+			 * @brief Get the number of values in this Stack.
+			 * @return The number of values in this Stack.
+			 */
+			size_t size() const {
+				return count;
+			}
+
+			/**
+			 * @brief Checks if this Stack is empty.
+			 * @return True if this Stack has no values, false otherwise.
+			 */
+			bool empty() const {
+				return count == 0;
+			}
+
+			/**
+			 * @brief Removes every value from this Stack without releasing any memory.
+			 */
+			void clear() {
+				count = 0;
+			}
+
+			/**
+			 * @brief Ensures this Stack can hold at least @p size values without allocating.
+			 * @param[in] size The number of values.
+			 */
+			void reserve(size_t size) {
+				if (size <= capacity) { return; }
+
+				auto memory = std::make_unique<T[]>(size);
+				std::copy(first, first + count, memory.get());
+
+				heap = std::move(memory);
+				first = heap.get();
+				capacity = size;
+			}
+
+			/**
+			 * @brief Empties this Stack and lends out its storage for @p size values, for code that keeps track of its own top.
+			 * The values written are not part of this Stack, and are overwritten by the next push().
+			 * @param[in] size The number of values needed.
+			 * @return Space for @p size values, valid until this Stack is next changed.
+			 */
+			T* scratch(size_t size) {
+				clear();
+				reserve(size);
+				return first;
+			}
+
+			/**
+			 * @brief Get the values of this Stack from the bottom to the top.
+			 * @return A pointer to the bottom value of this Stack.
+			 */
+			T* data() {
+				return first;
+			}
+
+			/** @copydoc data() */
+			const T* data() const {
+				return first;
+			}
+
+		private:
+			/** The inline storage */
+			T storage[N];
+
+			/** The heap storage. Only used once the Stack has grown larger than N. */
+			std::unique_ptr<T[]> heap;
+
+			/** The storage currently in use */
+			T* first = storage;
+
+			/** The number of values in the Stack */
+			size_t count = 0;
+
+			/** The number of values #first can hold */
+			size_t capacity = N;
+	};
+}
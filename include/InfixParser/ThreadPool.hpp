@@ -0,0 +1,151 @@
+#pragma once
+
+// STD
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace InfixParser {
+	/**
+	 * @brief A fixed set of worker threads that split ranges of work between them using work stealing.
+	 *
+	 * Each call to run() divides the work into chunks and gives every worker an equal share of them.
+	 * Workers take chunks from the front of their own share and, once it is empty, steal the back half
+	 * of another worker's share. This keeps every worker busy even when the cost of items varies widely.
+	 *
+	 * Example usage:
+	 * @code
+	 * ThreadPool pool{8};
+	 * pool.run(items.size(), 16, [&](size_t worker, size_t begin, size_t end) {
+	 *     for (auto i = begin; i < end; ++i) { process(items[i]); }
+	 * });
+	 * @endcode
+	 */
+	class ThreadPool {
+		public:
+			/**
+			 * @brief The type of the function called for each chunk of work.
+			 * @param[in] worker The index of the worker running the chunk. Less than size().
+			 * @param[in] begin The first item in the chunk.
+			 * @param[in] end One past the last item in the chunk.
+			 */
+			using Task = std::function<void(size_t worker, size_t begin, size_t end)>;
+
+			/**
+			 * @brief Constructs a thread pool.
+			 * @param[in] workers The number of workers, including the thread that calls run(). At least one.
+			 */
+			explicit ThreadPool(size_t workers = std::thread::hardware_concurrency());
+
+			/**
+			 * @brief Stops and joins every worker thread.
+			 */
+			~ThreadPool();
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			/**
+			 * @brief Get the number of workers, including the thread that calls run().
+			 * @return The number of workers.
+			 */
+			size_t size() const;
+
+			/**
+			 * @brief Calls @p task for every chunk of @p grain items in [0, @p count) and waits for them to finish.
+			 * The calling thread takes part as the last worker. Concurrent calls are run one at a time.
+			 *
+			 * @param[in] count The number of items.
+			 * @param[in] grain The number of items in each chunk. At least one.
+			 * @param[in] task The function to call for each chunk.
+			 * @throws Any exception thrown by @p task. Once a chunk throws the remaining chunks are still run.
+			 */
+			void run(size_t count, size_t grain, const Task& task);
+
+			/**
+			 * @brief Get the process-wide thread pool with one worker per hardware thread.
+			 * @return The process-wide thread pool.
+			 */
+			static ThreadPool& global();
+
+		private:
+			/** The chunks a worker has left, packed as (begin << 32) | end */
+			struct alignas(64) Share {
+				std::atomic<uint64_t> chunks{0};
+			};
+
+			/** The background threads. The thread calling run() is the last worker. */
+			std::vector<std::thread> threads;
+
+			/** The share of each worker */
+			std::unique_ptr<Share[]> shares;
+
+			/** Serializes calls to run() */
+			std::mutex run_mutex;
+
+			/** Guards every member below */
+			std::mutex mutex;
+
+			/** Signaled when there is new work or the pool is stopping */
+			std::condition_variable wake;
+
+			/** Signaled when a background thread finishes its work */
+			std::condition_variable done;
+
+			/** Incremented each time run() starts new work */
+			uint64_t generation = 0;
+
+			/** The number of background threads still working */
+			size_t active = 0;
+
+			/** True when the pool is being destroyed */
+			bool stopping = false;
+
+			/** The task of the current call to run() */
+			const Task* task = nullptr;
+
+			/** The number of items of the current call to run() */
+			size_t item_count = 0;
+
+			/** The number of items in each chunk of the current call to run() */
+			size_t item_grain = 1;
+
+			/** The first exception thrown by the current task */
+			std::exception_ptr error;
+
+			/**
+			 * @brief The loop run by each background thread.
+			 * @param[in] worker The index of the worker.
+			 */
+			void loop(size_t worker);
+
+			/**
+			 * @brief Runs chunks of the current task until no worker has any left.
+			 * @param[in] worker The index of the worker.
+			 */
+			void work(size_t worker);
+
+			/**
+			 * @brief Takes the first chunk from @p share.
+			 * @param[in,out] share The share to take from.
+			 * @param[out] chunk The chunk that was taken.
+			 * @return True if a chunk was taken, false if @p share is empty.
+			 */
+			static bool take(Share& share, uint32_t& chunk);
+
+			/**
+			 * @brief Takes the back half of the chunks from @p share.
+			 * @param[in,out] share The share to steal from.
+			 * @param[out] begin The first chunk that was stolen.
+			 * @param[out] end One past the last chunk that was stolen.
+			 * @return True if any chunks were stolen, false if @p share is empty.
+			 */
+			static bool steal(Share& share, uint32_t& begin, uint32_t& end);
+	};
+}
@@ -1,7 +1,13 @@
 #pragma once
 
 // STD
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <vector>
+
+// InfixParser
+#include <InfixParser/Error.hpp>
 
 namespace Test {
 	/**
@@ -17,4 +23,84 @@ namespace Test {
 	 * @param[in] print If set to true then when an exception is thrown exception.what() will be printed.
 	 */
 	void check_equation_throws(const std::string& equation, bool print);
+
+	/**
+	 * @brief Checks if InfixParser::Evaluator::try_evaluate reports @p error at @p position for @p equation,
+	 * and that its message is the same as the message of the exception InfixParser::Evaluator::evaluate throws.
+	 * @param[in] equation The equation to check.
+	 * @param[in] error The expected error.
+	 * @param[in] position The expected position of the error.
+	 * @param[in] print If set to true then the message of the error will be printed.
+	 */
+	void check_error(const std::string& equation, InfixParser::Error error, size_t position, bool print);
+
+	/**
+	 * @brief Checks if InfixParser::eval gives @p equation the same value, or the same error at the same position,
+	 * as InfixParser::Evaluator::try_evaluate. Called by the checks above, so every equation they test is also evaluated by eval().
+	 * @param[in] equation The equation to check. Equations of 512 characters or more are not checked.
+	 */
+	void check_eval(const std::string& equation);
+
+	/**
+	 * @brief Checks if @p equation evaluates to @p expected using InfixParser::Evaluator::compile.
+	 * The compiled expression is run more than once to ensure that running it does not modify it.
+	 * @param[in] equation The equation to check.
+	 * @param[in] expected The expected value.
+	 */
+	void check_compiled(const std::string& equation, int expected);
+
+	/**
+	 * @brief Checks if @p equation evaluates to @p expected using InfixParser::Evaluator::compile with the variable values @p values.
+	 * @param[in] equation The equation to check.
+	 * @param[in] values The value of each variable in the order they first appear in @p equation.
+	 * @param[in] expected The expected value.
+	 */
+	void check_compiled(const std::string& equation, const std::vector<int>& values, int expected);
+
+	/**
+	 * @brief Checks if @p equation compiles to @p instructions instructions and evaluates to @p expected with the variable values @p values.
+	 * @param[in] equation The equation to check.
+	 * @param[in] values The value of each variable in the order they first appear in @p equation.
+	 * @param[in] instructions The expected number of instructions after optimization.
+	 * @param[in] expected The expected value.
+	 */
+	void check_optimized(const std::string& equation, const std::vector<int>& values, size_t instructions, int expected);
+
+	/**
+	 * @brief Checks if InfixParser::CompiledExpression::run_batch gives the same results as InfixParser::CompiledExpression::run for @p equation.
+	 * Each variable in @p equation is given a column of @p rows generated values between -20 and 20.
+	 * @param[in] equation The equation to check.
+	 * @param[in] rows The number of rows to check.
+	 */
+	void check_batch(const std::string& equation, size_t rows);
+
+	/**
+	 * @brief Checks if InfixParser::CompiledExpression::filter and InfixParser::CompiledExpression::filter_bitmap
+	 * select the rows InfixParser::CompiledExpression::run_batch gives a non-zero result for.
+	 * Each variable in @p equation is given a column of @p rows generated values between -20 and 20.
+	 * @param[in] equation The equation to check.
+	 * @param[in] rows The number of rows to check.
+	 */
+	void check_filter(const std::string& equation, size_t rows);
+
+	/**
+	 * @brief Checks if InfixParser::ExpressionSet::run_batch and InfixParser::ExpressionSet::run give the same results
+	 * as running each of @p equations on its own.
+	 * Each variable in @p equations is given a column of @p rows generated values between -20 and 20.
+	 * @param[in] equations The equations to check.
+	 * @param[in] rows The number of rows to check.
+	 */
+	void check_expression_set(const std::vector<std::string>& equations, size_t rows);
+
+	/**
+	 * @brief Get the number of times operator new has been called by this program.
+	 * @return The number of times operator new has been called.
+	 */
+	size_t allocation_count();
+
+	/**
+	 * @brief Checks that evaluating @p equation with a warmed up InfixParser::Evaluator does not allocate memory.
+	 * @param[in] equation The equation to check. Must be well formed and not larger than any previously checked equation.
+	 */
+	void check_no_allocations(std::string_view equation);
 }
\ No newline at end of file
@@ -5,6 +5,14 @@ require "premake5/actions"
 -------------------------------------------------------------------------------
 PROJECT_NAME = "InfixParser"
 
+-------------------------------------------------------------------------------
+-- Options
+-------------------------------------------------------------------------------
+newoption {
+	trigger = "stats",
+	description = "Count the work each evaluator does. See BasicEvaluator::statistics().",
+}
+
 -------------------------------------------------------------------------------
 -- The files and folders to delete when the "clean" action is run.
 -------------------------------------------------------------------------------
@@ -16,23 +24,29 @@ action_clean_directories = {
 }	
 
 action_clean_files = {
-	"./".. PROJECT_NAME ..".vcxproj",
-	"./".. PROJECT_NAME ..".vcxproj.filters",
-	"./".. PROJECT_NAME ..".vcxproj.user",
 	"./".. PROJECT_NAME .."Workspace.sln",
 	"./".. PROJECT_NAME .."Workspace.VC.db",
-	"./".. PROJECT_NAME .."Workspace.VC.VC.opendb"
+	"./".. PROJECT_NAME .."Workspace.VC.VC.opendb",
+	"./Makefile",
 }
 
+for _, name in ipairs({PROJECT_NAME, PROJECT_NAME .."Test", PROJECT_NAME .."Bench"}) do
+	table.insert(action_clean_files, "./".. name ..".vcxproj")
+	table.insert(action_clean_files, "./".. name ..".vcxproj.filters")
+	table.insert(action_clean_files, "./".. name ..".vcxproj.user")
+	table.insert(action_clean_files, "./".. name ..".make")
+end
+
 -------------------------------------------------------------------------------
 -- The main premake settings
 -------------------------------------------------------------------------------
 workspace(PROJECT_NAME .."Workspace")
 	configurations {"Debug", "Release"}
-	platforms {"Windows_x64"}
+	platforms {"Windows_x64", "Linux_x64"}
 	characterset "Unicode"
 	kind "ConsoleApp"
 	language "C++"
+	cppdialect "C++17"
 	rtti "Off"
 	warnings "Default"
 	flags {"FatalWarnings"}
@@ -51,9 +65,19 @@ workspace(PROJECT_NAME .."Workspace")
 	end
 	
 	filter "platforms:Windows_x64"
-        architecture "x64"
+		system "windows"
+		architecture "x64"
 		defines {string.upper(PROJECT_NAME) .."_OS_WINDOWS"}
+
+	filter "platforms:Linux_x64"
+		system "linux"
+		architecture "x64"
+		defines {string.upper(PROJECT_NAME) .."_OS_LINUX"}
+		links {"pthread"}
 		
+	filter "options:stats"
+		defines {string.upper(PROJECT_NAME) .."_STATS"}
+
 	filter "configurations:Debug"
 		symbols "On"
 		defines {"DEBUG"}
@@ -62,9 +86,37 @@ workspace(PROJECT_NAME .."Workspace")
 		optimize "Full"
 		defines {"NDEBUG", "RELEASE"}
 
+filter {}
+
+-------------------------------------------------------------------------------
+-- The library, shared by the command line tool and the benchmarks
+-------------------------------------------------------------------------------
 project(PROJECT_NAME)
+	kind "StaticLib"
 	files {
-		"./include/**",
-		"./src/**",
+		"./include/InfixParser/**",
+		"./src/InfixParser/**",
+	}
+
+-------------------------------------------------------------------------------
+-- The command line tool and its tests
+-------------------------------------------------------------------------------
+project(PROJECT_NAME .."Test")
+	links {PROJECT_NAME}
+	files {
+		"./include/Test/**",
+		"./src/Test/**",
+		"./src/main.cpp",
 	}
 	debugdir "./src"
+
+-------------------------------------------------------------------------------
+-- The benchmarks. Run with --json for machine-readable results.
+-------------------------------------------------------------------------------
+project(PROJECT_NAME .."Bench")
+	links {PROJECT_NAME}
+	files {
+		"./include/Bench/**",
+		"./src/Bench/**",
+		"./src/Test/Allocations.cpp",
+	}
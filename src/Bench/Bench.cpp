@@ -0,0 +1,68 @@
+// STD
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+// Bench
+#include <Bench/Bench.hpp>
+
+namespace Bench {
+	Runner::Runner(int argc, char* argv[]) {
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view argument = argv[i];
+
+			if (argument == "--json") {
+				json = true;
+			} else if (argument == "--filter" && i + 1 < argc) {
+				filter = argv[++i];
+			} else if (argument == "--min-time" && i + 1 < argc) {
+				min_time = std::chrono::milliseconds{std::strtoul(argv[++i], nullptr, 10)};
+			} else {
+				std::fprintf(stderr, "Usage: %s [--json] [--filter <text>] [--min-time <ms>]\n", argv[0]);
+				std::exit(argument == "--help" ? 0 : 2);
+			}
+		}
+
+		if (!json) {
+			std::printf("%-40s %14s %12s %14s %12s\n", "Benchmark", "Iterations", "ns/op", "MB/s", "allocs/op");
+		}
+	}
+
+	const std::vector<Result>& Runner::results() const {
+		return reported;
+	}
+
+	int Runner::finish() {
+		std::fflush(stdout);
+		return 0;
+	}
+
+	bool Runner::selected(const std::string& name) const {
+		return name.find(filter) != std::string::npos;
+	}
+
+	void Runner::report(const std::string& name, size_t bytes, size_t iterations, double nanoseconds, size_t allocations) {
+		Result result;
+		result.name = name;
+		result.iterations = iterations;
+		result.ns_per_op = nanoseconds / static_cast<double>(iterations);
+		result.bytes_per_second = static_cast<double>(bytes) * 1e9 / result.ns_per_op;
+		result.allocations_per_op = static_cast<double>(allocations) / static_cast<double>(iterations);
+
+		if (json) {
+			// Names never contain characters that need escaping
+			std::printf(
+				"{\"name\": \"%s\", \"iterations\": %zu, \"ns_per_op\": %.3f, \"bytes_per_second\": %.0f, \"allocations_per_op\": %.3f}\n",
+				result.name.c_str(), result.iterations, result.ns_per_op, result.bytes_per_second, result.allocations_per_op
+			);
+		} else {
+			std::printf(
+				"%-40s %14zu %12.2f %14.2f %12.3f\n",
+				result.name.c_str(), result.iterations, result.ns_per_op, result.bytes_per_second / 1e6, result.allocations_per_op
+			);
+		}
+
+		std::fflush(stdout);
+		reported.push_back(std::move(result));
+	}
+}
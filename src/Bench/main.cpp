@@ -0,0 +1,617 @@
+// STD
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// InfixParser
+#include <InfixParser/InfixParser.hpp>
+#include <InfixParser/Evaluator.hpp>
+#include <InfixParser/Operator.hpp>
+#include <InfixParser/OperatorRegistry.hpp>
+#include <InfixParser/CompiledExpression.hpp>
+#include <InfixParser/FormulaGraph.hpp>
+#include <InfixParser/ExpressionSet.hpp>
+#include <InfixParser/ExpressionPack.hpp>
+
+// Bench
+#include <Bench/Bench.hpp>
+
+/**
+ * @brief Builds a flat equation of about @p length characters.
+ * @param[in] length The minimum length of the equation.
+ * @return The equation.
+ */
+std::string long_equation(size_t length) {
+	static const char* const terms[] = {"12 * 3", "- 7", "+ 100 / 4", "- 2 ^ 3", "+ 45 % 7", "+ (1 + 2) * 3"};
+	std::string equation = "1";
+
+	for (size_t i = 0; equation.size() < length; ++i) {
+		equation += ' ';
+		equation += i % 6 == 0 ? "+" : "";
+		equation += terms[i % 6];
+	}
+
+	return equation;
+}
+
+/**
+ * @brief Builds an equation with @p depth levels of nested parentheses.
+ * @param[in] depth The number of nested parentheses.
+ * @return The equation.
+ */
+std::string nested_equation(size_t depth) {
+	std::string equation;
+
+	for (size_t i = 0; i < depth; ++i) {
+		equation += "(1 + ";
+	}
+
+	equation += "1";
+	equation.append(depth, ')');
+
+	return equation;
+}
+
+void tokenize_benchmarks(Bench::Runner& runner) {
+	const std::string numbers = "1 22 333 4444 55555 666666 7777777 88888888 999999999 1234567890";
+	const std::string identifiers = "alpha beta_2 gamma delta_epsilon zeta eta theta iota kappa lambda";
+	const std::string whitespace = std::string(64, ' ') + "1";
+
+	runner.run("tokenize/read_number", numbers.size(), [&] {
+		const char* it = numbers.data();
+		const char* end = it + numbers.size();
+		int value = 0;
+
+		while (it != end) {
+			it = InfixParser::skip_whitespace(it, end);
+			InfixParser::read_number(it, end, value);
+			Bench::keep(value);
+		}
+	});
+
+	runner.run("tokenize/read_identifier", identifiers.size(), [&] {
+		const char* it = identifiers.data();
+		const char* end = it + identifiers.size();
+
+		while (it != end) {
+			it = InfixParser::skip_whitespace(it, end);
+			Bench::keep(InfixParser::read_identifier(it, end).size());
+		}
+	});
+
+	runner.run("tokenize/skip_whitespace", whitespace.size(), [&] {
+		Bench::keep(InfixParser::skip_whitespace(whitespace.data(), whitespace.data() + whitespace.size()));
+	});
+}
+
+/** The operators a token starting with a given character could represent before operators were registered */
+struct TokenEntry {
+	const InfixParser::Operator* single = nullptr;
+	char second = '\0';
+	const InfixParser::Operator* pair = nullptr;
+};
+
+void operator_lookup_benchmarks(Bench::Runner& runner) {
+	using InfixParser::Operator;
+	const std::string operators = "+-*/%^++--==!=>=<=&&||()!><+-*/%^++--==!=>=<=&&||()!><";
+
+	// The lookup table the evaluator used before the registry
+	static const auto table = []{
+		std::array<TokenEntry, 256> table = {};
+
+		table['+'] = {&Operator::ADD, '+', &Operator::PRE_INCREMENT};
+		table['-'] = {&Operator::SUBTRACT, '-', &Operator::PRE_DECREMENT};
+		table['>'] = {&Operator::GREATER, '=', &Operator::GREATER_OR_EQUAL};
+		table['<'] = {&Operator::LESS, '=', &Operator::LESS_OR_EQUAL};
+		table['!'] = {&Operator::NOT, '=', &Operator::NOT_EQUAL};
+		table['&'] = {nullptr, '&', &Operator::AND};
+		table['|'] = {nullptr, '|', &Operator::OR};
+		table['='] = {nullptr, '=', &Operator::EQUAL};
+		table['('] = {&Operator::LEFT_PAREN};
+		table[')'] = {&Operator::RIGHT_PAREN};
+		table['^'] = {&Operator::POWER};
+		table['*'] = {&Operator::MULTIPLY};
+		table['/'] = {&Operator::DIVIDE};
+		table['%'] = {&Operator::REMAINDER};
+
+		return table;
+	}();
+
+	runner.run("tokenize/read_operator/table", operators.size(), [&] {
+		const char* it = operators.data();
+		const char* end = it + operators.size();
+
+		while (it != end) {
+			const auto& entry = table[static_cast<unsigned char>(*it)];
+			auto op = entry.single;
+
+			if (entry.pair != nullptr && it + 1 != end && it[1] == entry.second) {
+				op = entry.pair;
+				it += 2;
+			} else {
+				it += 1;
+			}
+
+			if (op == &Operator::SUBTRACT) {
+				op = &Operator::NEGATE;
+			}
+
+			Bench::keep(op);
+		}
+	});
+
+	// The same operators, and with registered operators that share their prefixes
+	static InfixParser::OperatorRegistry extended;
+
+	if (!extended.is_frozen()) {
+		// Only looked up, never applied
+		for (const char* symbol : {"<<", ">>", "&", "|", "**", "<<=", ">>=", "~", "!!", "==="}) {
+			extended.add(symbol, 5, false, 2, nullptr);
+		}
+
+		extended.freeze();
+	}
+
+	using Registry = std::pair<const char*, const InfixParser::OperatorRegistry*>;
+
+	for (const auto& [name, registry] : {Registry{"predefined", &InfixParser::OperatorRegistry::predefined()}, Registry{"extended", &extended}}) {
+		runner.run("tokenize/read_operator/" + std::string{name}, operators.size(), [&, registry = registry] {
+			const char* it = operators.data();
+			const char* end = it + operators.size();
+
+			while (it != end) {
+				Bench::keep(registry->match(it, end, true));
+			}
+		});
+	}
+}
+
+void evaluate_benchmarks(Bench::Runner& runner) {
+	static const std::pair<const char*, std::string> equations[] = {
+		{"evaluate/short", "1 + 2 * 3"},
+		{"evaluate/medium", "(4 >= 4) && 0 || (2 ^ 10 - 24) / 10 % 7 != -3"},
+		{"evaluate/long", long_equation(4096)},
+		{"evaluate/nested", nested_equation(200)},
+	};
+
+	InfixParser::Evaluator evaluator;
+
+	for (const auto& [name, equation] : equations) {
+		runner.run(name, equation.size(), [&] {
+			Bench::keep(evaluator.evaluate(equation));
+		});
+	}
+
+	const std::string compiled = long_equation(256);
+	const auto expression = evaluator.compile(compiled);
+
+	runner.run("evaluate/compile", compiled.size(), [&] {
+		Bench::keep(evaluator.compile(compiled).max_depth());
+	});
+
+	runner.run("evaluate/run", compiled.size(), [&] {
+		Bench::keep(expression.run());
+	});
+}
+
+void error_benchmarks(Bench::Runner& runner) {
+	static const std::pair<const char*, std::string> equations[] = {
+		{"error/divide_by_zero", "1 + 2 * (3 / 0)"},
+		{"error/unbalanced", "1 + 2 * 3) + 4"},
+		{"error/missing_operand", "1 + * 3"},
+		{"error/unknown_token", "1 + 2 * 3 # 4"},
+	};
+
+	InfixParser::Evaluator evaluator;
+
+	for (const auto& [name, equation] : equations) {
+		runner.run(name, equation.size(), [&] {
+			try {
+				evaluator.evaluate(equation);
+			} catch (const InfixParser::EvaluationException& except) {
+				Bench::keep(except.what()[0]);
+			}
+		});
+	}
+
+	// The same equations without an exception or a message
+	for (const auto& [name, equation] : equations) {
+		runner.run("error/try_evaluate/" + std::string{name + 6}, equation.size(), [&] {
+			Bench::keep(evaluator.try_evaluate(equation).error);
+		});
+	}
+
+	const std::string annotated = long_equation(128);
+
+	runner.run("error/throw_annotated", annotated.size(), [&] {
+		try {
+			InfixParser::throw_annotated(annotated, "Division by zero.", annotated.size() / 2);
+		} catch (const InfixParser::EvaluationException& except) {
+			Bench::keep(except.what()[0]);
+		}
+	});
+}
+
+void operator_benchmarks(Bench::Runner& runner) {
+	static const std::pair<const char*, const InfixParser::Operator*> operators[] = {
+		{"operator/negate", &InfixParser::Operator::NEGATE},
+		{"operator/not", &InfixParser::Operator::NOT},
+		{"operator/pre_increment", &InfixParser::Operator::PRE_INCREMENT},
+		{"operator/pre_decrement", &InfixParser::Operator::PRE_DECREMENT},
+		{"operator/power", &InfixParser::Operator::POWER},
+		{"operator/multiply", &InfixParser::Operator::MULTIPLY},
+		{"operator/divide", &InfixParser::Operator::DIVIDE},
+		{"operator/remainder", &InfixParser::Operator::REMAINDER},
+		{"operator/add", &InfixParser::Operator::ADD},
+		{"operator/subtract", &InfixParser::Operator::SUBTRACT},
+		{"operator/greater", &InfixParser::Operator::GREATER},
+		{"operator/greater_or_equal", &InfixParser::Operator::GREATER_OR_EQUAL},
+		{"operator/less", &InfixParser::Operator::LESS},
+		{"operator/less_or_equal", &InfixParser::Operator::LESS_OR_EQUAL},
+		{"operator/equal", &InfixParser::Operator::EQUAL},
+		{"operator/not_equal", &InfixParser::Operator::NOT_EQUAL},
+		{"operator/and", &InfixParser::Operator::AND},
+		{"operator/or", &InfixParser::Operator::OR},
+		{"operator/checked_negate", &InfixParser::Operator::CHECKED_NEGATE},
+		{"operator/checked_power", &InfixParser::Operator::CHECKED_POWER},
+		{"operator/checked_multiply", &InfixParser::Operator::CHECKED_MULTIPLY},
+		{"operator/checked_divide", &InfixParser::Operator::CHECKED_DIVIDE},
+		{"operator/checked_add", &InfixParser::Operator::CHECKED_ADD},
+	};
+
+	InfixParser::OperandStack operands;
+
+	for (const auto& [name, op] : operators) {
+		// Apply the operator to a fresh set of operands each time so its cost does not depend on previous results
+		runner.run(name, 0, [&, op = op] {
+			operands.clear();
+			operands.push(7);
+			operands.push(3);
+			op->apply(operands);
+			Bench::keep(operands.top());
+		});
+	}
+}
+
+/**
+ * @brief Builds an equation of @p terms variables joined by cheap operators, so that no part of it can be folded.
+ * @param[in] terms The number of variables in the equation.
+ * @return The equation.
+ */
+std::string variable_equation(size_t terms) {
+	static const char* const operators[] = {" + ", " * ", " - ", " < ", " == ", " && ", " || ", " + -"};
+	static const char* const variables[] = {"a", "b", "c", "d"};
+	std::string equation = "a";
+
+	for (size_t i = 1; i < terms; ++i) {
+		equation += operators[i % 8];
+		equation += variables[i % 4];
+	}
+
+	return equation;
+}
+
+void dispatch_benchmarks(Bench::Runner& runner) {
+	InfixParser::Evaluator evaluator;
+	InfixParser::OperandStack operands;
+	const int values[] = {3, 5, 7, 11};
+
+	for (const size_t terms : {4, 512}) {
+		const auto expression = evaluator.compile(variable_equation(terms), {"a", "b", "c", "d"});
+		const auto instructions = std::to_string(expression.instructions().size());
+
+		// The path every operator took before the threaded interpreter. ns/op divided by the instruction count is the cost of one.
+		runner.run("dispatch/apply/" + instructions, 0, [&] {
+			operands.clear();
+
+			for (const auto& instruction : expression.instructions()) {
+				switch (instruction.type) {
+					case InfixParser::Instruction::Type::VALUE:
+						operands.push(instruction.value);
+						break;
+					case InfixParser::Instruction::Type::VARIABLE:
+						operands.push(values[instruction.value]);
+						break;
+					case InfixParser::Instruction::Type::OPERATOR:
+						instruction.op->apply(operands);
+						break;
+					default:
+						// Run both sides of && and || so every operator is applied
+						break;
+				}
+			}
+
+			Bench::keep(operands.top());
+		});
+
+		runner.run("dispatch/threaded/" + instructions, 0, [&] {
+			Bench::keep(expression.run(values, operands));
+		});
+	}
+}
+
+/**
+ * @brief Builds an equation of @p terms variables joined by arithmetic operators that can overflow, so that no part of it can be folded.
+ * @param[in] terms The number of variables in the equation.
+ * @return The equation.
+ */
+std::string arithmetic_equation(size_t terms) {
+	static const char* const operators[] = {" + ", " * ", " - ", " / ", " + -", " ^ 2 + ", " - ++"};
+	static const char* const variables[] = {"a", "b", "c", "d"};
+	std::string equation = "a";
+
+	for (size_t i = 1; i < terms; ++i) {
+		equation += operators[i % 7];
+		equation += variables[i % 4];
+	}
+
+	return equation;
+}
+
+void arithmetic_benchmarks(Bench::Runner& runner) {
+	InfixParser::Evaluator evaluator;
+	InfixParser::OperandStack operands;
+	const int values[] = {3, 5, 7, 11};
+	const auto equation = arithmetic_equation(64);
+	const std::string constant = "(12345 * 678 - 9 ^ 7) / 13 + --2147483 * 3 - -(44 ^ 3)";
+
+	// Columns of small values so that no row overflows
+	std::vector<std::vector<int>> columns(4, std::vector<int>(4096));
+	std::vector<int> results(4096);
+
+	for (size_t row = 0; row < results.size(); ++row) {
+		for (size_t i = 0; i < columns.size(); ++i) {
+			columns[i][row] = static_cast<int>((row * 7 + i * 13) % 19) + 1;
+		}
+	}
+
+	const int* column_pointers[] = {columns[0].data(), columns[1].data(), columns[2].data(), columns[3].data()};
+
+	for (const bool checked : {false, true}) {
+		evaluator.set_checked(checked);
+
+		const auto expression = evaluator.compile(equation, {"a", "b", "c", "d"});
+		const std::string mode = checked ? "checked" : "wrapping";
+
+		runner.run("arithmetic/evaluate/" + mode, constant.size(), [&] {
+			Bench::keep(evaluator.evaluate(constant));
+		});
+
+		runner.run("arithmetic/run/" + mode, 0, [&] {
+			Bench::keep(expression.run(values, operands));
+		});
+
+		runner.run("arithmetic/run_batch/" + mode, results.size() * sizeof(int) * 4, [&] {
+			expression.run_batch(column_pointers, results.data(), results.size());
+			Bench::keep(results[0]);
+		});
+	}
+}
+
+void function_benchmarks(Bench::Runner& runner) {
+	// Each built-in function next to the comparisons it replaces
+	static const std::pair<const char*, const char*> equations[] = {
+		{"max", "max(a, b)"},
+		{"max/emulated", "(a > b) * a + (a <= b) * b"},
+		{"abs", "abs(a - b)"},
+		{"abs/emulated", "(a > b) * (a - b) + (a <= b) * (b - a)"},
+		{"clamp", "clamp(a, b, c)"},
+		{"clamp/emulated", "(a < b) * b + (a > c) * c + (a >= b && a <= c) * a"},
+	};
+
+	InfixParser::Evaluator evaluator;
+	InfixParser::OperandStack operands;
+	const int values[] = {3, 5, 7, 11};
+
+	// Columns where the low bound, b, is never above the high bound, c
+	std::vector<std::vector<int>> columns(3, std::vector<int>(4096));
+	std::vector<int> results(4096);
+
+	for (size_t row = 0; row < results.size(); ++row) {
+		columns[0][row] = static_cast<int>((row * 7) % 41) - 20;
+		columns[1][row] = static_cast<int>((row * 3) % 11) - 10;
+		columns[2][row] = static_cast<int>((row * 5) % 13);
+	}
+
+	const int* column_pointers[] = {columns[0].data(), columns[1].data(), columns[2].data()};
+
+	for (const auto& [name, equation] : equations) {
+		const auto expression = evaluator.compile(equation, {"a", "b", "c"});
+
+		runner.run("function/run/" + std::string{name}, 0, [&] {
+			Bench::keep(expression.run(values, operands));
+		});
+
+		runner.run("function/run_batch/" + std::string{name}, results.size() * sizeof(int) * 3, [&] {
+			expression.run_batch(column_pointers, results.data(), results.size());
+			Bench::keep(results[0]);
+		});
+	}
+}
+
+void formula_benchmarks(Bench::Runner& runner) {
+	// Two layers of formulas over 100 inputs, where each input reaches 150 of the 10000 formulas
+	constexpr int inputs = 100;
+	constexpr int width = 5000;
+	InfixParser::FormulaGraph graph;
+	InfixParser::Evaluator evaluator;
+	std::vector<InfixParser::CompiledExpression> first;
+	std::vector<InfixParser::CompiledExpression> second;
+
+	for (int i = 0; i < inputs; ++i) {
+		graph.set("x" + std::to_string(i), i);
+	}
+
+	for (int i = 0; i < width; ++i) {
+		const auto f = "x" + std::to_string(i % inputs) + " * 2 + " + std::to_string(i);
+		const auto g = "f" + std::to_string(i) + " - f" + std::to_string((i + 1) % width);
+		graph.define("f" + std::to_string(i), f);
+		graph.define("g" + std::to_string(i), g);
+		first.push_back(evaluator.compile(f, {"x" + std::to_string(i % inputs)}));
+		second.push_back(evaluator.compile(g, {"f" + std::to_string(i), "f" + std::to_string((i + 1) % width)}));
+	}
+
+	graph.recompute();
+	int tick = 0;
+
+	runner.run("formula/recompute/one_input", 0, [&] {
+		graph.set("x0", ++tick);
+		graph.recompute();
+		Bench::keep(graph.recomputed());
+	});
+
+	// Recomputing every formula in topological order, as without the graph
+	std::vector<int> values(inputs);
+	std::vector<int> results(width);
+	InfixParser::OperandStack operands;
+
+	runner.run("formula/recompute/all", 0, [&] {
+		values[0] = ++tick;
+
+		for (int i = 0; i < width; ++i) {
+			results[i] = first[i].run(&values[i % inputs], operands);
+		}
+
+		for (int i = 0; i < width; ++i) {
+			const int pair[] = {results[i], results[(i + 1) % width]};
+			Bench::keep(second[i].run(pair, operands));
+		}
+	});
+}
+
+void expression_set_benchmarks(Bench::Runner& runner) {
+	// Rules that share a prefix and compare it against their own threshold
+	const std::string shared = "max((a + b) * c - d, abs(e - a)) / (clamp(b, 1, 9) + 1)";
+	InfixParser::Evaluator evaluator;
+	std::vector<InfixParser::CompiledExpression> expressions;
+	const std::vector<std::string> variables = {"a", "b", "c", "d", "e"};
+
+	for (int i = 0; i < 64; ++i) {
+		expressions.push_back(evaluator.compile(shared + " > " + std::to_string(i) + " && e != " + std::to_string(i % 8), variables));
+	}
+
+	const InfixParser::ExpressionSet set{expressions};
+
+	std::vector<std::vector<int>> columns(variables.size(), std::vector<int>(4096));
+	std::vector<const int*> column_pointers;
+	std::vector<std::vector<int>> results(expressions.size(), std::vector<int>(4096));
+	std::vector<int*> result_pointers;
+
+	for (size_t i = 0; i < columns.size(); ++i) {
+		for (size_t row = 0; row < columns[i].size(); ++row) {
+			columns[i][row] = static_cast<int>((row * 7 + i * 13) % 41) - 20;
+		}
+
+		column_pointers.push_back(columns[i].data());
+	}
+
+	for (auto& result : results) {
+		result_pointers.push_back(result.data());
+	}
+
+	runner.run("expression_set/run_batch/separate", 0, [&] {
+		for (size_t i = 0; i < expressions.size(); ++i) {
+			expressions[i].run_batch(column_pointers.data(), result_pointers[i], 4096);
+		}
+
+		Bench::keep(results[0][0]);
+	});
+
+	runner.run("expression_set/run_batch/shared", 0, [&] {
+		set.run_batch(column_pointers.data(), result_pointers.data(), 4096);
+		Bench::keep(results[0][0]);
+	});
+}
+
+void pack_benchmarks(Bench::Runner& runner) {
+	// Starting up with 1000 rules, either compiling them or loading them from a pack, then running each once
+	const auto path = (std::filesystem::temp_directory_path() / "InfixParserBench.pack").string();
+	InfixParser::Evaluator evaluator;
+	std::vector<std::string> equations;
+	std::vector<InfixParser::CompiledExpression> expressions;
+	const std::vector<std::string> variables = {"price", "quantity", "discount", "limit"};
+
+	for (int i = 0; i < 1000; ++i) {
+		equations.push_back("price * quantity - discount * " + std::to_string(i % 17) + " > limit + " + std::to_string(i) + " || quantity % " + std::to_string(i % 5 + 2) + " == 0");
+		expressions.push_back(evaluator.compile(equations.back(), variables));
+	}
+
+	InfixParser::ExpressionPack::write(path, expressions);
+	const int values[] = {25, 4, 3, 90};
+	InfixParser::OperandStack operands;
+
+	runner.run("pack/start/compile", 0, [&] {
+		for (const auto& equation : equations) {
+			Bench::keep(evaluator.compile(equation, variables).run(values, operands));
+		}
+	});
+
+	runner.run("pack/start/load", 0, [&] {
+		const InfixParser::ExpressionPack pack{path};
+
+		for (size_t i = 0; i < pack.size(); ++i) {
+			Bench::keep(pack.run(i, values, operands));
+		}
+	});
+
+	std::remove(path.c_str());
+}
+
+/**
+ * @brief Measures evaluating and running the same equation with @p evaluator.
+ * @param[in] runner The runner to report to.
+ * @param[in] name The name of the value type.
+ * @param[in] evaluator The evaluator of the value type.
+ */
+template<class T>
+void type_benchmark(Bench::Runner& runner, const std::string& name, InfixParser::BasicEvaluator<T>& evaluator) {
+	const auto equation = arithmetic_equation(64);
+	const std::string constant = "(12345 * 678 - 9 ^ 7) / 13 + --2147483 * 3 - -(44 ^ 3)";
+	const auto expression = evaluator.compile(equation, {"a", "b", "c", "d"});
+	const T values[] = {3, 5, 7, 11};
+	InfixParser::BasicOperandStack<T> operands;
+
+	runner.run("type/evaluate/" + name, constant.size(), [&] {
+		Bench::keep(evaluator.evaluate(constant));
+	});
+
+	runner.run("type/run/" + name, 0, [&] {
+		Bench::keep(expression.run(values, operands));
+	});
+}
+
+void type_benchmarks(Bench::Runner& runner) {
+	InfixParser::Evaluator int32;
+	InfixParser::Int64Evaluator int64;
+	InfixParser::DoubleEvaluator real;
+
+	type_benchmark(runner, "int", int32);
+	type_benchmark(runner, "int64", int64);
+#if defined(INFIXPARSER_INT128)
+	InfixParser::Int128Evaluator int128;
+	type_benchmark(runner, "int128", int128);
+#endif
+	type_benchmark(runner, "double", real);
+}
+
+int main(int argc, char* argv[]) {
+	Bench::Runner runner{argc, argv};
+
+	tokenize_benchmarks(runner);
+	operator_lookup_benchmarks(runner);
+	evaluate_benchmarks(runner);
+	error_benchmarks(runner);
+	operator_benchmarks(runner);
+	dispatch_benchmarks(runner);
+	arithmetic_benchmarks(runner);
+	function_benchmarks(runner);
+	formula_benchmarks(runner);
+	expression_set_benchmarks(runner);
+	pack_benchmarks(runner);
+	type_benchmarks(runner);
+
+	return runner.finish();
+}
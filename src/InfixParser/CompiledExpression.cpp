@@ -0,0 +1,669 @@
+// STD
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+// InfixParser
+#include <InfixParser/CompiledExpression.hpp>
+#include <InfixParser/Evaluator.hpp>
+#include <InfixParser/Kernels.hpp>
+#include <InfixParser/Arithmetic.hpp>
+
+namespace {
+	template<class T>
+	bool is_jump(const InfixParser::BasicInstruction<T>& instruction) {
+		using Type = typename InfixParser::BasicInstruction<T>::Type;
+		return instruction.type == Type::JUMP_IF_FALSE || instruction.type == Type::JUMP_IF_TRUE;
+	}
+
+	// Get the space run_block() needs for the rows it selects, a block for each jump that could be nested in another
+	template<class T>
+	size_t selection_space(const std::vector<InfixParser::BasicInstruction<T>>& program, size_t block_size) {
+		return static_cast<size_t>(std::count_if(program.cbegin(), program.cend(), is_jump<T>)) * block_size;
+	}
+}
+
+// Computed goto is a GCC and Clang extension
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(INFIXPARSER_NO_COMPUTED_GOTO)
+	#define INFIXPARSER_COMPUTED_GOTO
+#endif
+
+namespace InfixParser {
+	template<class T>
+	BasicCompiledExpression<T>::BasicCompiledExpression(std::string source, std::vector<Instruction> program, std::vector<std::string> names, size_t depth)
+		: source{std::move(source)}
+		, program{std::move(program)}
+		, names{std::move(names)}
+		, depth{depth} {
+		code.reserve(this->program.size() + 1);
+
+		for (const auto& instruction : this->program) {
+			code.push_back(encode(instruction));
+		}
+
+		code.push_back({Code::END, 0});
+	}
+
+	template<class T>
+	T BasicCompiledExpression<T>::run() const {
+		OperandStack operands;
+		return run(operands);
+	}
+
+	template<class T>
+	T BasicCompiledExpression<T>::run(OperandStack& operands) const {
+		return run(nullptr, operands);
+	}
+
+	template<class T>
+	T BasicCompiledExpression<T>::run(const T* values) const {
+		OperandStack operands;
+		return run(values, operands);
+	}
+
+	template<class T>
+	T BasicCompiledExpression<T>::run(const T* values, OperandStack& operands) const {
+		const auto result = try_run(values, operands);
+
+		if (!result.ok()) {
+			throw EvaluationException{result.message(source)};
+		}
+
+		return result.value;
+	}
+
+	template<class T>
+	BasicEvaluationResult<T> BasicCompiledExpression<T>::try_run(const T* values, OperandStack& operands) const {
+		const auto stack = operands.scratch(depth);
+
+		// Let execute() report errors and run operators the interpreter does not know
+		if (interpret(code.data(), values, stack) != program.size()) {
+			return execute(program.data(), program.data() + program.size(), values, operands);
+		}
+
+		return {stack[0]};
+	}
+
+	template<class T>
+	void BasicCompiledExpression<T>::run_batch(const T* const* columns, T* results, size_t rows) const {
+		const auto kernels = find_kernels();
+
+		// Each operand on the stack is a block of values
+		std::vector<T> stack(depth * block_size);
+		std::vector<size_t> selections(selection_space(program, block_size));
+
+		for (size_t offset = 0; offset < rows; offset += block_size) {
+			const Rows block = {nullptr, offset, std::min(block_size, rows - offset)};
+			run_block(0, program.size(), kernels.data(), columns, block, stack.data(), selections.data());
+
+			// Get the results
+			std::copy(stack.data(), stack.data() + block.count, results + offset);
+		}
+	}
+
+	template<class T>
+	void BasicCompiledExpression<T>::filter(const T* const* columns, size_t rows, std::vector<size_t>& selection) const {
+		const auto kernels = find_kernels();
+		std::vector<T> stack(depth * block_size);
+
+		// The rows of a block, and space to reorder them in that run_block() also selects rows in
+		std::vector<size_t> block_selection(block_size);
+		std::vector<size_t> scratch(std::max(block_size, selection_space(program, block_size)));
+
+		selection.clear();
+
+		for (size_t offset = 0; offset < rows; offset += block_size) {
+			const auto count = std::min(block_size, rows - offset);
+
+			// Start with every row in the block selected
+			for (size_t i = 0; i < count; ++i) {
+				block_selection[i] = offset + i;
+			}
+
+			const auto passed = filter_range(0, program.size(), kernels.data(), columns, block_selection.data(), count, scratch.data(), stack.data());
+			selection.insert(selection.end(), block_selection.cbegin(), block_selection.cbegin() + static_cast<ptrdiff_t>(passed));
+		}
+	}
+
+	template<class T>
+	void BasicCompiledExpression<T>::filter_bitmap(const T* const* columns, size_t rows, std::vector<uint64_t>& bitmap) const {
+		std::vector<size_t> selection;
+		filter(columns, rows, selection);
+
+		bitmap.assign((rows + 63) / 64, 0);
+
+		for (const auto row : selection) {
+			bitmap[row / 64] |= uint64_t{1} << (row % 64);
+		}
+	}
+
+	template<class T>
+	std::vector<Kernels::Kernel> BasicCompiledExpression<T>::find_kernels() const {
+		std::vector<Kernels::Kernel> kernels(program.size());
+
+		// The kernels only operate on ints
+		if constexpr (std::is_same_v<T, int>) {
+			for (size_t i = 0; i < program.size(); ++i) {
+				if (program[i].type == Instruction::Type::OPERATOR) {
+					kernels[i] = Kernels::find(program[i].op);
+				}
+			}
+		}
+
+		return kernels;
+	}
+
+	template<class T>
+	size_t BasicCompiledExpression<T>::left_end(size_t right) const {
+		return right != 0 && is_jump(program[right - 1]) ? right - 1 : right;
+	}
+
+	template<class T>
+	size_t BasicCompiledExpression<T>::operand_begin(size_t end) const {
+		// Walk backwards until every operand the instructions need has been produced
+		int needed = 1;
+		auto i = end;
+
+		while (needed > 0) {
+			--i;
+
+			// Jumps neither produce nor use operands
+			if (is_jump(program[i])) {
+				continue;
+			}
+
+			if (program[i].type == Instruction::Type::OPERATOR) {
+				needed += program[i].op->arity();
+			}
+
+			--needed;
+		}
+
+		return i;
+	}
+
+	template<class T>
+	void BasicCompiledExpression<T>::run_block(size_t begin, size_t end, const Kernels::Kernel* kernels, const T* const* columns, const Rows& rows, T* stack, size_t* selections) const {
+		const auto count = rows.count;
+		auto top = stack;
+
+		for (auto i = begin; i < end; ++i) {
+			const auto& instruction = program[i];
+			const auto& kernel = kernels[i];
+
+			switch (instruction.type) {
+				case Instruction::Type::VALUE: {
+					std::fill(top, top + count, instruction.value);
+					top += block_size;
+					break;
+				}
+				case Instruction::Type::VARIABLE: {
+					const auto column = columns[static_cast<size_t>(instruction.value)];
+
+					if (rows.selection) {
+						for (size_t row = 0; row < count; ++row) {
+							top[row] = column[rows.selection[row]];
+						}
+					} else {
+						std::copy(column + rows.offset, column + rows.offset + count, top);
+					}
+
+					top += block_size;
+					break;
+				}
+				case Instruction::Type::JUMP_IF_FALSE:
+				case Instruction::Type::JUMP_IF_TRUE: {
+					// The right side only runs for rows the left side is true for with &&, or false for with ||
+					const auto runs_if_true = instruction.type == Instruction::Type::JUMP_IF_FALSE;
+					const auto left = top - block_size;
+					const auto target = i + 1 + static_cast<size_t>(instruction.value);
+					size_t undecided = 0;
+
+					for (size_t row = 0; row < count; ++row) {
+						undecided += (left[row] != 0) == runs_if_true;
+					}
+
+					// Run the right side as normal when no row is decided
+					if (undecided == count) {
+						break;
+					}
+
+					// Run the right side for only the undecided rows. Jumps within it select from the next block of selections.
+					if (undecided != 0) {
+						size_t selected = 0;
+
+						for (size_t row = 0; row < count; ++row) {
+							if ((left[row] != 0) == runs_if_true) {
+								selections[selected++] = rows.selection ? rows.selection[row] : rows.offset + row;
+							}
+						}
+
+						run_block(i + 1, target - 1, kernels, columns, {selections, 0, selected}, top, selections + block_size);
+					}
+
+					// Combine the results and skip the right side and the operator
+					for (size_t row = 0, next = 0; row < count; ++row) {
+						if ((left[row] != 0) == runs_if_true) {
+							left[row] = top[next++] != 0;
+						} else {
+							left[row] = !runs_if_true;
+						}
+					}
+
+					i = target - 1;
+					break;
+				}
+				case Instruction::Type::OPERATOR: {
+					const auto arity = static_cast<size_t>(instruction.op->arity());
+					top -= arity * block_size;
+
+					size_t applied = 0;
+
+					if constexpr (std::is_same_v<T, int>) {
+						if (kernel.unary) {
+							applied = kernel.unary(top, count);
+						} else if (kernel.binary) {
+							applied = kernel.binary(top, top + block_size, count);
+						} else if (kernel.ternary) {
+							applied = kernel.ternary(top, top + block_size, top + 2 * block_size, count);
+						}
+					}
+
+					// Apply the operator to the rows without a kernel, or let it report why it could not be applied
+					if (applied != count) {
+						apply_rows(instruction, top, applied, rows);
+					}
+
+					top += block_size;
+					break;
+				}
+			}
+		}
+	}
+
+	template<class T>
+	size_t BasicCompiledExpression<T>::filter_range(size_t begin, size_t end, const Kernels::Kernel* kernels, const T* const* columns, size_t* selection, size_t count, size_t* scratch, T* stack) const {
+		if (count == 0) { return 0; }
+
+		const auto& last = program[end - 1];
+
+		// Merges the ascending runs [selection + first, selection + middle) and [selection + middle, selection + last) in place
+		const auto merge = [&](size_t first, size_t middle, size_t last) {
+			std::merge(selection + first, selection + middle, selection + middle, selection + last, scratch);
+			std::copy(scratch, scratch + (last - first), selection + first);
+		};
+
+		if (last.type == Instruction::Type::OPERATOR) {
+			// Only rows that pass the left side of an AND need to be checked by the right side
+			if (last.op == &Operator::AND) {
+				const auto split = operand_begin(end - 1);
+				const auto left = filter_range(begin, left_end(split), kernels, columns, selection, count, scratch, stack);
+				const auto passed = filter_range(split, end - 1, kernels, columns, selection, left, scratch, stack);
+
+				// Both sides fail the rows after the passed rows
+				merge(passed, left, count);
+				return passed;
+			}
+
+			// Only rows that fail the left side of an OR need to be checked by the right side
+			if (last.op == &Operator::OR) {
+				const auto split = operand_begin(end - 1);
+				const auto left = filter_range(begin, left_end(split), kernels, columns, selection, count, scratch, stack);
+				const auto right = filter_range(split, end - 1, kernels, columns, selection + left, count - left, scratch, stack);
+
+				merge(0, left, left + right);
+				return left + right;
+			}
+
+			// Rows pass a NOT when they fail its operand
+			if (last.op == &Operator::NOT) {
+				const auto passed = filter_range(begin, end - 1, kernels, columns, selection, count, scratch, stack);
+				std::rotate(selection, selection + passed, selection + count);
+				return count - passed;
+			}
+		}
+
+		// Evaluate anything else and move the rows with a non-zero result to the front
+		const Rows rows = {selection, 0, count};
+		run_block(begin, end, kernels, columns, rows, stack, scratch);
+
+		size_t kept = 0;
+		size_t failed = 0;
+
+		for (size_t i = 0; i < count; ++i) {
+			if (stack[i] != 0) {
+				selection[kept++] = selection[i];
+			} else {
+				scratch[failed++] = selection[i];
+			}
+		}
+
+		std::copy(scratch, scratch + failed, selection + kept);
+		return kept;
+	}
+
+	template<class T>
+	void BasicCompiledExpression<T>::apply_rows(const Instruction& instruction, T* operands, size_t begin, const Rows& rows) const {
+		const auto arity = static_cast<size_t>(instruction.op->arity());
+		OperandStack row_operands;
+
+		for (auto row = begin; row < rows.count; ++row) {
+			row_operands.clear();
+
+			for (size_t i = 0; i < arity; ++i) {
+				row_operands.push(operands[i * block_size + row]);
+			}
+
+			if (const auto error = instruction.op->apply(row_operands); error != Error::NONE) {
+				const EvaluationResult result = {0, error, instruction.position, instruction.op};
+				const auto index = rows.selection ? rows.selection[row] : rows.offset + row;
+				throw_annotated(source, result.description(source) + " (row " + std::to_string(index) + ")", instruction.position);
+			}
+
+			operands[row] = row_operands.top();
+		}
+	}
+
+	template<class T>
+	const std::string& BasicCompiledExpression<T>::equation() const {
+		return source;
+	}
+
+	template<class T>
+	const std::vector<BasicInstruction<T>>& BasicCompiledExpression<T>::instructions() const {
+		return program;
+	}
+
+	template<class T>
+	const std::vector<std::string>& BasicCompiledExpression<T>::variables() const {
+		return names;
+	}
+
+	template<class T>
+	size_t BasicCompiledExpression<T>::max_depth() const {
+		return depth;
+	}
+
+	template<class T>
+	BasicEvaluationResult<T> BasicCompiledExpression<T>::execute(const Instruction* begin, const Instruction* end, const T* values, OperandStack& operands) {
+		return execute(begin, end, values, operands, [](const Operator&) {});
+	}
+
+	template<class T>
+	typename BasicCompiledExpression<T>::Operation BasicCompiledExpression<T>::encode(const Instruction& instruction) {
+		static const std::pair<const Operator*, Code> operators[] = {
+			{&Operator::NEGATE, Code::NEGATE},
+			{&Operator::NOT, Code::NOT},
+			{&Operator::PRE_INCREMENT, Code::PRE_INCREMENT},
+			{&Operator::PRE_DECREMENT, Code::PRE_DECREMENT},
+			{&Operator::POWER, Code::POWER},
+			{&Operator::MULTIPLY, Code::MULTIPLY},
+			{&Operator::DIVIDE, Code::DIVIDE},
+			{&Operator::REMAINDER, Code::REMAINDER},
+			{&Operator::ADD, Code::ADD},
+			{&Operator::SUBTRACT, Code::SUBTRACT},
+			{&Operator::GREATER, Code::GREATER},
+			{&Operator::GREATER_OR_EQUAL, Code::GREATER_OR_EQUAL},
+			{&Operator::LESS, Code::LESS},
+			{&Operator::LESS_OR_EQUAL, Code::LESS_OR_EQUAL},
+			{&Operator::EQUAL, Code::EQUAL},
+			{&Operator::NOT_EQUAL, Code::NOT_EQUAL},
+			{&Operator::AND, Code::AND},
+			{&Operator::OR, Code::OR},
+			{&Operator::ABS, Code::ABS},
+			{&Operator::MIN, Code::MIN},
+			{&Operator::MAX, Code::MAX},
+			{&Operator::CLAMP, Code::CLAMP},
+			{&Operator::CHECKED_NEGATE, Code::CHECKED_NEGATE},
+			{&Operator::CHECKED_PRE_INCREMENT, Code::CHECKED_PRE_INCREMENT},
+			{&Operator::CHECKED_PRE_DECREMENT, Code::CHECKED_PRE_DECREMENT},
+			{&Operator::CHECKED_POWER, Code::CHECKED_POWER},
+			{&Operator::CHECKED_MULTIPLY, Code::CHECKED_MULTIPLY},
+			{&Operator::CHECKED_DIVIDE, Code::CHECKED_DIVIDE},
+			{&Operator::CHECKED_ADD, Code::CHECKED_ADD},
+			{&Operator::CHECKED_SUBTRACT, Code::CHECKED_SUBTRACT},
+			{&Operator::CHECKED_ABS, Code::CHECKED_ABS},
+		};
+
+		switch (instruction.type) {
+			case Instruction::Type::VALUE:
+				return {Code::VALUE, instruction.value};
+			case Instruction::Type::VARIABLE:
+				return {Code::VARIABLE, instruction.value};
+			case Instruction::Type::JUMP_IF_FALSE:
+				return {Code::JUMP_IF_FALSE, instruction.value};
+			case Instruction::Type::JUMP_IF_TRUE:
+				return {Code::JUMP_IF_TRUE, instruction.value};
+			case Instruction::Type::OPERATOR:
+				break;
+		}
+
+		for (const auto& [op, code] : operators) {
+			if (op == instruction.op) { return {code, 0}; }
+		}
+
+		return {Code::APPLY, 0};
+	}
+
+	template<class T>
+	size_t BasicCompiledExpression<T>::interpret(const Operation* first, const T* values, T* stack) {
+		auto pc = first;
+
+		// The top operand. The stack starts empty.
+		auto top = stack - 1;
+
+	#if defined(INFIXPARSER_COMPUTED_GOTO)
+		// Jump straight from each operation to the next. Must be in the same order as Code.
+		static const void* const labels[] = {
+			&&VALUE, &&VARIABLE, &&JUMP_IF_FALSE, &&JUMP_IF_TRUE,
+			&&NEGATE, &&NOT, &&PRE_INCREMENT, &&PRE_DECREMENT,
+			&&POWER, &&MULTIPLY, &&DIVIDE, &&REMAINDER, &&ADD, &&SUBTRACT,
+			&&GREATER, &&GREATER_OR_EQUAL, &&LESS, &&LESS_OR_EQUAL, &&EQUAL, &&NOT_EQUAL, &&AND, &&OR,
+			&&ABS, &&MIN, &&MAX, &&CLAMP,
+			&&CHECKED_NEGATE, &&CHECKED_PRE_INCREMENT, &&CHECKED_PRE_DECREMENT,
+			&&CHECKED_POWER, &&CHECKED_MULTIPLY, &&CHECKED_DIVIDE, &&CHECKED_ADD, &&CHECKED_SUBTRACT, &&CHECKED_ABS,
+			&&APPLY, &&END,
+		};
+
+		#define INFIXPARSER_OPERATION(name) name:
+		#define INFIXPARSER_NEXT goto *labels[static_cast<size_t>((++pc)->code)]
+
+		goto *labels[static_cast<size_t>(pc->code)];
+	#else
+		#define INFIXPARSER_OPERATION(name) case Code::name:
+		#define INFIXPARSER_NEXT ++pc; continue
+
+		while (true) switch (pc->code) {
+	#endif
+			INFIXPARSER_OPERATION(VALUE) {
+				*++top = pc->value;
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(VARIABLE) {
+				*++top = values[static_cast<size_t>(pc->value)];
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(JUMP_IF_FALSE) {
+				if (*top == 0) { pc += static_cast<ptrdiff_t>(pc->value); }
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(JUMP_IF_TRUE) {
+				if (*top != 0) {
+					*top = 1;
+					pc += static_cast<ptrdiff_t>(pc->value);
+				}
+
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(NEGATE) {
+				*top = Arithmetic::negate(*top);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(NOT) {
+				*top = !*top;
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(PRE_INCREMENT) {
+				*top = Arithmetic::add(*top, T{1});
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(PRE_DECREMENT) {
+				*top = Arithmetic::subtract(*top, T{1});
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(POWER) {
+				if (Arithmetic::power_divides_by_zero(top[-1], top[0])) { return pc - first; }
+				--top;
+				top[0] = Arithmetic::power(top[0], top[1]);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(MULTIPLY) {
+				--top;
+				top[0] = Arithmetic::multiply(top[0], top[1]);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(DIVIDE) {
+				if (top[0] == 0) { return pc - first; }
+				--top;
+				top[0] = Arithmetic::divide(top[0], top[1]);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(REMAINDER) {
+				if (top[0] == 0) { return pc - first; }
+				--top;
+				top[0] = Arithmetic::remainder(top[0], top[1]);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(ADD) {
+				--top;
+				top[0] = Arithmetic::add(top[0], top[1]);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(SUBTRACT) {
+				--top;
+				top[0] = Arithmetic::subtract(top[0], top[1]);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(GREATER) {
+				--top;
+				top[0] = top[0] > top[1];
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(GREATER_OR_EQUAL) {
+				--top;
+				top[0] = top[0] >= top[1];
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(LESS) {
+				--top;
+				top[0] = top[0] < top[1];
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(LESS_OR_EQUAL) {
+				--top;
+				top[0] = top[0] <= top[1];
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(EQUAL) {
+				--top;
+				top[0] = top[0] == top[1];
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(NOT_EQUAL) {
+				--top;
+				top[0] = top[0] != top[1];
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(AND) {
+				--top;
+				top[0] = top[0] && top[1];
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(OR) {
+				--top;
+				top[0] = top[0] || top[1];
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(ABS) {
+				*top = Arithmetic::absolute(*top);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(MIN) {
+				--top;
+				top[0] = Arithmetic::minimum(top[0], top[1]);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(MAX) {
+				--top;
+				top[0] = Arithmetic::maximum(top[0], top[1]);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(CLAMP) {
+				top -= 2;
+				top[0] = Arithmetic::clamp(top[0], top[1], top[2]);
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(CHECKED_NEGATE) {
+				if (Arithmetic::subtract_overflow(T{0}, *top, *top)) { return pc - first; }
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(CHECKED_PRE_INCREMENT) {
+				if (Arithmetic::add_overflow(*top, T{1}, *top)) { return pc - first; }
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(CHECKED_PRE_DECREMENT) {
+				if (Arithmetic::subtract_overflow(*top, T{1}, *top)) { return pc - first; }
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(CHECKED_POWER) {
+				if (Arithmetic::power_divides_by_zero(top[-1], top[0])) { return pc - first; }
+				--top;
+				if (Arithmetic::power_overflow(top[0], top[1], top[0])) { return pc - first; }
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(CHECKED_MULTIPLY) {
+				--top;
+				if (Arithmetic::multiply_overflow(top[0], top[1], top[0])) { return pc - first; }
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(CHECKED_DIVIDE) {
+				if (top[0] == 0) { return pc - first; }
+				--top;
+				if (Arithmetic::divide_overflow(top[0], top[1], top[0])) { return pc - first; }
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(CHECKED_ADD) {
+				--top;
+				if (Arithmetic::add_overflow(top[0], top[1], top[0])) { return pc - first; }
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(CHECKED_SUBTRACT) {
+				--top;
+				if (Arithmetic::subtract_overflow(top[0], top[1], top[0])) { return pc - first; }
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(CHECKED_ABS) {
+				if (Arithmetic::absolute_overflow(*top, *top)) { return pc - first; }
+				INFIXPARSER_NEXT;
+			}
+			INFIXPARSER_OPERATION(APPLY) {
+				return pc - first;
+			}
+			INFIXPARSER_OPERATION(END) {
+				return pc - first;
+			}
+	#if !defined(INFIXPARSER_COMPUTED_GOTO)
+		}
+	#endif
+
+		#undef INFIXPARSER_OPERATION
+		#undef INFIXPARSER_NEXT
+	}
+
+	template class BasicCompiledExpression<int>;
+	template class BasicCompiledExpression<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	template class BasicCompiledExpression<__int128>;
+#endif
+	template class BasicCompiledExpression<double>;
+}
@@ -0,0 +1,144 @@
+// STD
+#include <algorithm>
+#include <string>
+
+// InfixParser
+#include <InfixParser/Error.hpp>
+#include <InfixParser/InfixParser.hpp>
+#include <InfixParser/Operator.hpp>
+
+namespace {
+	// Get count followed by noun, such as "two operands", the way the messages of the operators have always been written
+	std::string count_of(int count, const char* noun) {
+		switch (count) {
+			case 1: return std::string{"one "} + noun;
+			case 2: return std::string{"two "} + noun + 's';
+			case 3: return std::string{"three "} + noun + 's';
+			default: return std::to_string(count) + ' ' + noun + 's';
+		}
+	}
+
+	// Get the name of op the way the messages of the operators have always been written, such as "^ (POWER)"
+	template<class T>
+	std::string name_of(const InfixParser::BasicOperator<T>& op) {
+		using InfixParser::OperatorKind;
+
+		const char* kind = nullptr;
+
+		switch (op.kind()) {
+			case OperatorKind::REGISTERED: break;
+			case OperatorKind::ABS: kind = "ABS"; break;
+			case OperatorKind::MIN: kind = "MIN"; break;
+			case OperatorKind::MAX: kind = "MAX"; break;
+			case OperatorKind::CLAMP: kind = "CLAMP"; break;
+			case OperatorKind::NEGATE: kind = "NEGATE"; break;
+			case OperatorKind::RIGHT_PAREN: kind = "RIGHT_PAREN"; break;
+			case OperatorKind::NOT: kind = "NOT"; break;
+			case OperatorKind::PRE_INCREMENT: kind = "PRE_INCREMENT"; break;
+			case OperatorKind::PRE_DECREMENT: kind = "PRE_DECREMENT"; break;
+			case OperatorKind::POWER: kind = "POWER"; break;
+			case OperatorKind::MULTIPLY: kind = "MULTIPLY"; break;
+			case OperatorKind::DIVIDE: kind = "DIVIDE"; break;
+			case OperatorKind::REMAINDER: kind = "REMAINDER"; break;
+			case OperatorKind::ADD: kind = "ADD"; break;
+			case OperatorKind::SUBTRACT: kind = "SUBTRACT"; break;
+			case OperatorKind::GREATER: kind = "GREATER"; break;
+			case OperatorKind::GREATER_OR_EQUAL: kind = "GREATER_OR_EQUAL"; break;
+			case OperatorKind::LESS: kind = "LESS"; break;
+			case OperatorKind::LESS_OR_EQUAL: kind = "LESS_OR_EQUAL"; break;
+			case OperatorKind::EQUAL: kind = "EQUAL"; break;
+			case OperatorKind::NOT_EQUAL: kind = "NOT_EQUAL"; break;
+			case OperatorKind::AND: kind = "AND"; break;
+			case OperatorKind::OR: kind = "OR"; break;
+			case OperatorKind::LEFT_PAREN: kind = "LEFT_PAREN"; break;
+			case OperatorKind::COMMA: kind = "COMMA"; break;
+		}
+
+		// Registered operators are only known by their symbol
+		return kind ? op.to_string() + " (" + kind + ')' : op.to_string();
+	}
+}
+
+namespace InfixParser {
+	const char* to_string(Error error) {
+		switch (error) {
+			case Error::NONE: return "";
+			case Error::EMPTY_EQUATION: return "Evaluator::evaluate only operates on non-empty equations.";
+			case Error::NUMBER_TOO_LARGE: return "Number is too large.";
+			case Error::UNKNOWN_OPERATOR: return "Unknown operator.";
+			case Error::UNKNOWN_VARIABLE: return "Unknown variable.";
+			case Error::EXPECTED_OPERATOR: return "Expected operator.";
+			case Error::EXPECTED_OPERAND: return "Expected operand.";
+			case Error::EXPECTED_FINAL_OPERAND: return "Expected operand after.";
+			case Error::EXTRANEOUS_PARENTHESIS: return "Extraneous \")\".";
+			case Error::TOO_MANY_OPERANDS: return "Ill formed equation. To many operands.";
+			case Error::MISSING_OPERANDS: return "Operator is missing operands.";
+			case Error::WRONG_ARGUMENT_COUNT: return "Function called with the wrong number of arguments.";
+			case Error::MISPLACED_COMMA: return "\",\" outside of a function call.";
+			case Error::DIVISION_BY_ZERO: return "Division by zero.";
+			case Error::REMAINDER_BY_ZERO: return "Remainder cannot be found when dividing by zero.";
+			case Error::INTEGER_OVERFLOW: return "Integer overflow.";
+		}
+
+		return "Unknown error.";
+	}
+
+	std::string annotate(std::string_view equation, std::string_view error, size_t pos) {
+		pos = std::min(pos, equation.size());
+
+		std::string message{error};
+		message += " @ character " + std::to_string(pos) + '\n';
+		message += equation;
+		message += '\n';
+		message += std::string(pos, ' ') + "^\n";
+		return message;
+	}
+
+	template<class T>
+	bool BasicEvaluationResult<T>::ok() const {
+		return error == Error::NONE;
+	}
+
+	template<class T>
+	std::string BasicEvaluationResult<T>::description(std::string_view equation) const {
+		if (error == Error::MISSING_OPERANDS && op) {
+			return "Operator " + name_of(*op) + " requires at least " + count_of(op->arity(), "operand") + '.';
+		}
+
+		if (error == Error::WRONG_ARGUMENT_COUNT && op) {
+			return "Function " + name_of(*op) + " takes " + count_of(op->arity(), "argument") + '.';
+		}
+
+		// The variable ends at the error
+		if (error == Error::UNKNOWN_VARIABLE && position < equation.size()) {
+			auto begin = position + 1;
+
+			while (begin != 0 && is_identifier(equation[begin - 1])) {
+				--begin;
+			}
+
+			return "Unknown variable \"" + std::string{equation.substr(begin, position + 1 - begin)} + "\".";
+		}
+
+		return to_string(error);
+	}
+
+	template<class T>
+	std::string BasicEvaluationResult<T>::message(std::string_view equation) const {
+		if (error == Error::NONE) { return {}; }
+
+		// There is nothing to point at in an empty equation
+		if (error == Error::EMPTY_EQUATION) {
+			return to_string(error);
+		}
+
+		return annotate(equation, description(equation), position);
+	}
+
+	template struct BasicEvaluationResult<int>;
+	template struct BasicEvaluationResult<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	template struct BasicEvaluationResult<__int128>;
+#endif
+	template struct BasicEvaluationResult<double>;
+}
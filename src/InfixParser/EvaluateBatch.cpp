@@ -0,0 +1,24 @@
+// InfixParser
+#include <InfixParser/EvaluateBatch.hpp>
+#include <InfixParser/Evaluator.hpp>
+
+namespace InfixParser {
+	std::vector<EvaluationResult> evaluate_batch(const std::string_view* equations, size_t count, ThreadPool& pool) {
+		std::vector<EvaluationResult> results(count);
+
+		// Equations are short, so give workers a few at a time to keep scheduling cheap
+		pool.run(count, 16, [&](size_t, size_t begin, size_t end) {
+			thread_local Evaluator evaluator;
+
+			for (auto i = begin; i < end; ++i) {
+				results[i] = evaluator.try_evaluate(equations[i]);
+			}
+		});
+
+		return results;
+	}
+
+	std::vector<EvaluationResult> evaluate_batch(const std::vector<std::string_view>& equations, ThreadPool& pool) {
+		return evaluate_batch(equations.data(), equations.size(), pool);
+	}
+}
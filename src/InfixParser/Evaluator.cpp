@@ -1,239 +1,468 @@
+// STD
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
 // InfixParser
 #include <InfixParser/Evaluator.hpp>
 #include <InfixParser/InfixParser.hpp>
 
+// Statements that only count the work of an evaluator, which are not compiled at all without INFIXPARSER_STATS
+#if defined(INFIXPARSER_STATS)
+	#define INFIXPARSER_STATS_ONLY(...) __VA_ARGS__
+#else
+	#define INFIXPARSER_STATS_ONLY(...)
+#endif
+
+namespace {
+	template<class T>
+	using Operator = InfixParser::BasicOperator<T>;
+
+	template<class T>
+	using Instruction = InfixParser::BasicInstruction<T>;
+
+	/** Each operator that can overflow and the operator that reports it instead */
+	template<class T>
+	const std::pair<const Operator<T>*, const Operator<T>*> checked_operators[] = {
+		{&Operator<T>::NEGATE, &Operator<T>::CHECKED_NEGATE},
+		{&Operator<T>::PRE_INCREMENT, &Operator<T>::CHECKED_PRE_INCREMENT},
+		{&Operator<T>::PRE_DECREMENT, &Operator<T>::CHECKED_PRE_DECREMENT},
+		{&Operator<T>::POWER, &Operator<T>::CHECKED_POWER},
+		{&Operator<T>::MULTIPLY, &Operator<T>::CHECKED_MULTIPLY},
+		{&Operator<T>::DIVIDE, &Operator<T>::CHECKED_DIVIDE},
+		{&Operator<T>::ADD, &Operator<T>::CHECKED_ADD},
+		{&Operator<T>::SUBTRACT, &Operator<T>::CHECKED_SUBTRACT},
+		{&Operator<T>::ABS, &Operator<T>::CHECKED_ABS},
+	};
+
+	/** The built-in functions by name */
+	template<class T>
+	const std::pair<std::string_view, const Operator<T>*> functions[] = {
+		{"abs", &Operator<T>::ABS},
+		{"min", &Operator<T>::MIN},
+		{"max", &Operator<T>::MAX},
+		{"clamp", &Operator<T>::CLAMP},
+	};
+
+	// Get the built-in function called name, or nullptr if there is none
+	template<class T>
+	const Operator<T>* find_function(std::string_view name) {
+		for (const auto& [function_name, function] : functions<T>) {
+			if (name == function_name) { return function; }
+		}
+
+		return nullptr;
+	}
+
+	// Get the checked version of op, or op if it cannot overflow
+	template<class T>
+	const Operator<T>* to_checked(const Operator<T>* op) {
+		for (const auto& [unchecked, checked] : checked_operators<T>) {
+			if (op == unchecked) { return checked; }
+		}
+
+		return op;
+	}
+
+	// Get the unchecked version of op, or op if it is not checked
+	template<class T>
+	const Operator<T>* to_unchecked(const Operator<T>* op) {
+		for (const auto& [unchecked, checked] : checked_operators<T>) {
+			if (op == checked) { return unchecked; }
+		}
+
+		return op;
+	}
+
+	template<class T>
+	bool is_value(const Instruction<T>& instruction) {
+		return instruction.type == Instruction<T>::Type::VALUE;
+	}
+
+	// Checks if x op value is x
+	// -0 + 0 is 0, so adding zero is only an identity for integers
+	template<class T>
+	bool is_right_identity(const Operator<T>* op, T value) {
+		return (value == 1 && (op == &Operator<T>::MULTIPLY || op == &Operator<T>::DIVIDE || op == &Operator<T>::POWER))
+			|| (value == 0 && ((op == &Operator<T>::ADD && std::is_integral_v<T>) || op == &Operator<T>::SUBTRACT));
+	}
+
+	// Checks if value op x is x
+	template<class T>
+	bool is_left_identity(const Operator<T>* op, T value) {
+		return (value == 1 && op == &Operator<T>::MULTIPLY) || (value == 0 && op == &Operator<T>::ADD && std::is_integral_v<T>);
+	}
+
+	// Checks if x op value and value op x have the same result for every x
+	// Infinity * 0 is not 0, so multiplying by zero only absorbs integers
+	template<class T>
+	bool is_absorbing(const Operator<T>* op, T value, T& result) {
+		result = op == &Operator<T>::OR;
+		return (value == 0 && ((op == &Operator<T>::MULTIPLY && std::is_integral_v<T>) || op == &Operator<T>::AND))
+			|| (value != 0 && op == &Operator<T>::OR);
+	}
+
+	// Checks if running the instructions [begin, end) could throw
+	// Registered operators could fail, so only the predefined operators that never do are safe
+	template<class T>
+	bool can_fail(const Instruction<T>* begin, const Instruction<T>* end) {
+		static const Operator<T>* const infallible[] = {
+			&Operator<T>::NEGATE, &Operator<T>::NOT, &Operator<T>::PRE_INCREMENT, &Operator<T>::PRE_DECREMENT, &Operator<T>::MULTIPLY,
+			&Operator<T>::ADD, &Operator<T>::SUBTRACT, &Operator<T>::GREATER, &Operator<T>::GREATER_OR_EQUAL, &Operator<T>::LESS,
+			&Operator<T>::LESS_OR_EQUAL, &Operator<T>::EQUAL, &Operator<T>::NOT_EQUAL, &Operator<T>::AND, &Operator<T>::OR,
+			&Operator<T>::ABS, &Operator<T>::MIN, &Operator<T>::MAX, &Operator<T>::CLAMP,
+		};
+
+		return std::any_of(begin, end, [](const Instruction<T>& instruction) {
+			return instruction.op != nullptr && std::find(std::begin(infallible), std::end(infallible), instruction.op) == std::end(infallible);
+		});
+	}
+}
+
 namespace InfixParser {
-	Evaluator::Evaluator() {
-	}
-
-	int Evaluator::evaluate(const std::string& equation) {
-		// Ensure we have a non-empty equation
-		if (equation.empty()) {
-			throw EvaluationException{"Evaluator::evaluate only operates on non-empty equations."};
-		}
-
-		// Ensure our stacks are empty
-		operands = decltype(operands){};
-		operators = decltype(operators){};
-		operator_depth = 1;
-
-		// Get some useful iterators
-		auto begin = equation.cbegin();
-		auto current = begin;
-		auto end = equation.cend();
-
-		// Parse the string
-		try {
-			while (current != end) {
-				// Ignore whitespaces
-				if (is_whitespace(*current)) {
-					++current;
-					continue;
-				}
-
-				// Handle numbers and tokens
-				if (is_number(*current)) {
-					if (operator_depth > 0) {
-						operands.push(read_number(current, end));
-						operator_depth = 0;
-					} else {
-						throw EvaluationException{"Expected operator."};
-					}
-
-					expect_operand = false;
-				} else {
-					handle_token(current, end);
-				}
-			}
+	template<class T>
+	BasicEvaluator<T>::BasicEvaluator(const BasicOperatorRegistry<T>& registry)
+		: registry{&registry} {
+		if (!registry.is_frozen()) {
+			throw OperatorRegistryException{"Evaluators can only use a frozen registry."};
+		}
+	}
 
-			// Apply any remaining operators
-			while (!operators.empty()) {
-				operators.top()->apply(operands);
-				operators.pop();
-			}
+	template<class T>
+	void BasicEvaluator<T>::set_checked(bool checked) {
+		this->checked = checked;
+	}
 
-			if (expect_operand) {
-				throw EvaluationException{"Expected operand after."};
-			}
+	template<class T>
+	bool BasicEvaluator<T>::is_checked() const {
+		return checked;
+	}
 
-			// Ensure that all operands have been used
-			if (operands.size() != 1) {
-				throw EvaluationException{"Ill formed equation. To many operands."};
-			}
-		} catch (EvaluationException& except) {
-			throw_annotated(equation, except.what(), current - begin - 1);
-		} catch (OperatorException& except) {
-			throw_annotated(equation, except.what(), current - begin - 1);
+	template<class T>
+	T BasicEvaluator<T>::evaluate(std::string_view equation) {
+		const auto result = try_evaluate(equation);
+
+		if (!result.ok()) {
+			INFIXPARSER_STATS_ONLY(++stats.exceptions;)
+			throw EvaluationException{result.message(equation)};
 		}
 
-		// Get the result
-		return operands.top();
+		return result.value;
 	}
 
-	const Operator* Evaluator::read_token(std::string::const_iterator& begin, const std::string::const_iterator& end) {
-		if (begin == end) { return nullptr; }
+	template<class T>
+	BasicEvaluationResult<T> BasicEvaluator<T>::try_evaluate(std::string_view equation) {
+		variables.clear();
+		declare_variables = false;
+		optimizing = false;
 
-		int next_offset = 1;
-		const Operator* op = nullptr;
+		if (const auto error = parse(equation); error != Error::NONE) {
+			return {0, error, error_position, error_operator};
+		}
 
-		// Translate from tokens to operators
-		if (begin[0] == '+') {
-			if (begin + 1 != end && begin[1] == '+') {
-				op = &Operator::PRE_INCREMENT;
-				next_offset = 2;
-			} else {
-				op = &Operator::ADD;
-			}
-		} else if (begin[0] == '-') {
-			if (begin + 1 != end && begin[1] == '-') {
-				op = &Operator::PRE_DECREMENT;
-				next_offset = 2;
-			} else {
-				if (operator_depth == 0) {
-					op = &Operator::SUBTRACT;
-				} else {
-					op = &Operator::NEGATE;
-				}
-			}
-		} else if (begin[0] == '>') {
-			if (begin + 1 != end && begin[1] == '=') {
-				op = &Operator::GREATER_OR_EQUAL;
-				next_offset = 2;
-			} else {
-				op = &Operator::GREATER;
-			}
-		} else if (begin[0] == '<') {
-			if (begin + 1 != end && begin[1] == '=') {
-				op = &Operator::LESS_OR_EQUAL;
-				next_offset = 2;
-			} else {
-				op = &Operator::LESS;
-			}
-		} else if (begin[0] == '!') {
-			if (begin + 1 != end && begin[1] == '=') {
-				op = &Operator::NOT_EQUAL;
-				next_offset = 2;
-			} else {
-				op = &Operator::NOT;
-			}
-		} else if (begin[0] == '&') {
-			if (begin + 1 != end && begin[1] == '&') {
-				op = &Operator::AND;
-				next_offset = 2;
-			}
-		} else if (begin[0] == '|') {
-			if (begin + 1 != end && begin[1] == '|') {
-				op = &Operator::OR;
-				next_offset = 2;
-			}
-		} else if (begin[0] == '=') {
-			if (begin + 1 != end && begin[1] == '=') {
-				op = &Operator::EQUAL;
-				next_offset = 2;
-			}
-		} else if (begin[0] == '(') {
-			op = &Operator::LEFT_PAREN;
-		} else if (begin[0] == ')') {
-			op = &Operator::RIGHT_PAREN;
-		} else if (begin[0] == '^') {
-			op = &Operator::POWER;
-		} else if (begin[0] == '*') {
-			op = &Operator::MULTIPLY;
-		} else if (begin[0] == '/') {
-			op = &Operator::DIVIDE;
-		} else if (begin[0] == '%') {
-			op = &Operator::REMAINDER;
-		}
-
-		begin += next_offset;
-		return op;
+#if defined(INFIXPARSER_STATS)
+		const auto start = std::chrono::steady_clock::now();
+		const auto result = CompiledExpression::execute(program.data(), program.data() + program.size(), nullptr, operands, [this](const Operator& op) {
+			++stats.applied[static_cast<size_t>(op.kind())];
+		});
+
+		stats.applying += std::chrono::steady_clock::now() - start;
+		return result;
+#else
+		return CompiledExpression::execute(program.data(), program.data() + program.size(), nullptr, operands);
+#endif
 	}
 
-	void Evaluator::handle_token(std::string::const_iterator& begin, const std::string::const_iterator& end) {
-		if (begin == end) { return; }
+	template<class T>
+	BasicCompiledExpression<T> BasicEvaluator<T>::compile(std::string_view equation) {
+		variables.clear();
+		declare_variables = true;
+		optimizing = true;
 
-		// Ensure we are dealing with a token
-		if (is_whitespace(*begin)) { return; }
-		if (is_number(*begin)) { return; }
+		return link(equation);
+	}
 
-		// Translate from a token to an operator
-		auto op = read_token(begin, end);
+	template<class T>
+	BasicCompiledExpression<T> BasicEvaluator<T>::compile(std::string_view equation, const std::vector<std::string>& variables) {
+		this->variables = variables;
+		declare_variables = false;
+		optimizing = true;
 
-		if (op == nullptr) {
-			throw EvaluationException{"Unknown operator."};
+		return link(equation);
+	}
+
+	template<class T>
+	BasicCompiledExpression<T> BasicEvaluator<T>::link(std::string_view equation) {
+		if (const auto error = parse(equation); error != Error::NONE) {
+			const EvaluationResult result = {0, error, error_position, error_operator};
+			INFIXPARSER_STATS_ONLY(++stats.exceptions;)
+			throw EvaluationException{result.message(equation)};
 		}
 
-		// Handle the operator
-		handle_operator(op);
+		return CompiledExpression{std::string{equation}, program, variables, max_stack_depth};
+	}
+
+	template<class T>
+	typename BasicEvaluator<T>::Statistics BasicEvaluator<T>::statistics() const {
+		return stats;
+	}
+
+	template<class T>
+	void BasicEvaluator<T>::reset_statistics() {
+		stats = {};
+	}
+
+	template<class T>
+	uint64_t BasicEvaluator<T>::Statistics::applications(const Operator* op) const {
+		return applied[static_cast<size_t>(op->kind())];
+	}
+
+	template<class T>
+	typename BasicEvaluator<T>::Statistics& BasicEvaluator<T>::Statistics::operator+=(const Statistics& other) {
+		equations += other.equations;
+		tokens += other.tokens;
+		max_operands = std::max(max_operands, other.max_operands);
+		max_operators = std::max(max_operators, other.max_operators);
+		exceptions += other.exceptions;
+		converting += other.converting;
+		applying += other.applying;
+
+		for (size_t kind = 0; kind < operator_kinds; ++kind) {
+			applied[kind] += other.applied[kind];
+		}
 
-		// Handle the rest of the string
-		handle_token(begin, end);
+		return *this;
 	}
 
-	void Evaluator::handle_operator(const Operator* op) {
-		// Get useful information about the operator
-		const auto is_right_associative = op->is_right_associative();
-		const auto precedence = op->precedence();
+	template<class T>
+	Error BasicEvaluator<T>::parse(std::string_view equation) {
+#if defined(INFIXPARSER_STATS)
+		// Timing each token would take longer than reading it, so the conversion is timed once
+		const auto start = std::chrono::steady_clock::now();
+		const auto error = build(equation);
 
-		// Increase operator depth
-		++operator_depth;
+		++stats.equations;
+		stats.converting += std::chrono::steady_clock::now() - start;
 
-		// Store if we are expecting an operand in the future.
-		if (is_right_associative) {
-			expect_operand = true;
+		if (error == Error::NONE) {
+			stats.max_operands = std::max<uint64_t>(stats.max_operands, max_stack_depth);
 		}
 
-		// Handle left parentheses
-		if (op == &Operator::LEFT_PAREN) {
-			operators.push(op);
+		return error;
+#else
+		return build(equation);
+#endif
+	}
+
+	template<class T>
+	OperatorKind BasicEvaluator<T>::kind(const Operator* op) {
+		return op->kind();
+	}
+
+	template<class T>
+	int BasicEvaluator<T>::precedence(const Operator* op) {
+		return op->precedence();
+	}
+
+	template<class T>
+	bool BasicEvaluator<T>::is_right_associative(const Operator* op) {
+		return op->is_right_associative();
+	}
+
+	template<class T>
+	int BasicEvaluator<T>::arity(const Operator* op) {
+		return op->arity();
+	}
+
+	template<class T>
+	const char* BasicEvaluator<T>::skip_whitespace(const char* begin, const char* end) {
+		return InfixParser::skip_whitespace(begin, end);
+	}
+
+	template<class T>
+	bool BasicEvaluator<T>::read_number(const char*& begin, const char* end, T& value) {
+		return InfixParser::read_number(begin, end, value);
+	}
+
+	template<class T>
+	const BasicOperator<T>* BasicEvaluator<T>::match(const char*& begin, const char* end, bool prefix) const {
+		// Translate from tokens to operators. A token that does not follow an operand is a prefix operator, so - is a negation.
+		return registry->match(begin, end, prefix);
+	}
+
+	template<class T>
+	const BasicOperator<T>* BasicEvaluator<T>::find_function(std::string_view name) const {
+		return ::find_function<T>(name);
+	}
+
+	template<class T>
+	void BasicEvaluator<T>::begin_program() {
+		program.clear();
+		operand_begins.clear();
+	}
+
+	template<class T>
+	void BasicEvaluator<T>::emit_operand(Type type, T value) {
+		operand_begins.push(program.size());
+		program.push_back({type, nullptr, value, position});
+	}
+
+	template<class T>
+	void BasicEvaluator<T>::emit_operator(const Operator* op, size_t arity, size_t jump) {
+		program.push_back({Type::OPERATOR, checked ? to_checked(op) : op, 0, position});
+
+		// Make the jump after the left side of && and || skip to here
+		if (jump != no_jump) {
+			program[jump].value = static_cast<T>(program.size() - jump - 1);
+		}
+
+		// The result starts where the first operand did
+		const auto right = operand_begins.top();
+
+		for (size_t i = 1; i < arity; ++i) {
+			operand_begins.pop();
+		}
+
+		if (optimizing) {
+			optimize(operand_begins.top(), right);
+		}
+	}
+
+	template<class T>
+	size_t BasicEvaluator<T>::emit_jump(Type type) {
+		const auto jump = program.size();
+		program.push_back({type, nullptr, 0, position});
+		return jump;
+	}
+
+	template<class T>
+	void BasicEvaluator<T>::lexed_token() {
+		INFIXPARSER_STATS_ONLY(++stats.tokens;)
+	}
+
+	template<class T>
+	void BasicEvaluator<T>::pushed_operator() {
+		INFIXPARSER_STATS_ONLY(stats.max_operators = std::max<uint64_t>(stats.max_operators, operators.size());)
+	}
+
+	template<class T>
+	bool BasicEvaluator<T>::resolve(std::string_view name, int& slot) {
+		auto found = std::find(variables.cbegin(), variables.cend(), name);
+
+		if (found != variables.cend()) {
+			slot = static_cast<int>(found - variables.cbegin());
+			return true;
+		}
+
+		if (!declare_variables) {
+			return false;
+		}
+
+		variables.emplace_back(name);
+		slot = static_cast<int>(variables.size() - 1);
+		return true;
+	}
+
+	template<class T>
+	void BasicEvaluator<T>::optimize(size_t left, size_t right) {
+		const auto end = program.size();
+		const auto emitted = program[end - 1].op;
+		const auto op = to_unchecked(emitted);
+		const auto arity = static_cast<size_t>(op->arity());
+
+		// Fold operators whose operands are all constant
+		if (std::all_of(program.cend() - 1 - arity, program.cend() - 1, is_value<T>)) {
+			operands.clear();
+
+			for (auto i = end - 1 - arity; i < end - 1; ++i) {
+				operands.push(program[i].value);
+			}
+
+			// Leave the operator to report the error when it is run
+			if (emitted->apply(operands) != Error::NONE) {
+				return;
+			}
+
+			replace(end - 1 - arity, operands.top());
 			return;
 		}
 
-		// Error if we were expecting an operand
-		if (!is_right_associative && expect_operand) {
-			throw EvaluationException{"Expected operand."};
+		if (arity == 1) {
+			const auto& previous = program[end - 2];
+
+			if (previous.type != Instruction::Type::OPERATOR) { return; }
+
+			// Cancel pairs of unary operators that undo each other
+			// Checked operators never cancel, since the first could overflow. Adding one to a large double can round, so ++ and -- only cancel for integers.
+			if ((emitted == &Operator::NEGATE && previous.op == &Operator::NEGATE)
+				|| (std::is_integral_v<T> && emitted == &Operator::PRE_INCREMENT && previous.op == &Operator::PRE_DECREMENT)
+				|| (std::is_integral_v<T> && emitted == &Operator::PRE_DECREMENT && previous.op == &Operator::PRE_INCREMENT)) {
+				program.resize(end - 2);
+			}
+
+			// !!!x is !x
+			if (op == &Operator::NOT && previous.op == &Operator::NOT && end >= 3
+				&& program[end - 3].type == Instruction::Type::OPERATOR && program[end - 3].op == &Operator::NOT) {
+				program.resize(end - 2);
+			}
+
+			return;
 		}
 
-		// Handle right parentheses
-		if (op == &Operator::RIGHT_PAREN) {
-			// Apply all operators until a left parenthesis is found
-			while (true) {
-				if (operators.empty()) {
-					throw EvaluationException{"Extraneous \"" + op->to_string() + "\"."};
-				}
+		// Apply identities where one operand is constant
+		const auto& constant = program[end - 2];
+		T result;
 
-				if (operators.top() == &Operator::LEFT_PAREN) {
-					break;
-				}
+		// A constant left side of && or || decides if the right side runs. The jump sits between the operands.
+		if ((op == &Operator::AND || op == &Operator::OR) && right - left == 2 && is_value(program[left])) {
+			const auto decided = (op == &Operator::AND) == (program[left].value == 0);
 
-				operators.top()->apply(operands);
-				operators.pop();
+			if (decided) {
+				replace(left, op == &Operator::OR);
+			} else if (is_value(constant)) {
+				replace(left, constant.value != 0);
 			}
 
-			// Remove the left parenthesis
-			operators.pop();
+			return;
 		}
 
-		// Handle all other operators
-		while (!operators.empty()) {
-			auto top_prec = operators.top()->precedence();
-			
-			if (precedence <= top_prec && !is_right_associative) {
-				operators.top()->apply(operands);
-				operators.pop();
-			} else {
-				break;
+		if (is_value(constant)) {
+			if (is_right_identity(op, constant.value)) {
+				// x * 1 is x
+				program.resize(end - 2);
+			} else if (is_absorbing(op, constant.value, result) && !can_fail(program.data() + left, program.data() + right)) {
+				// x && 0 is 0
+				replace(left, result);
+			}
+		} else if (right - left == 1 && is_value(program[left])) {
+			const auto value = program[left].value;
+
+			if (is_left_identity(op, value)) {
+				// 1 * x is x
+				program.pop_back();
+				program.erase(program.begin() + left);
+			} else if (is_absorbing(op, value, result) && !can_fail(program.data() + right, program.data() + end - 1)) {
+				// 0 && x is 0
+				replace(left, result);
 			}
 		}
+	}
 
-		// Add the operator to the stack
-		operators.push(op);
+	template<class T>
+	void BasicEvaluator<T>::replace(size_t begin, T value) {
+		const auto pos = program[begin].position;
+		program.resize(begin);
+		program.push_back({Instruction::Type::VALUE, nullptr, value, pos});
 	}
 
-	void Evaluator::throw_annotated(const std::string& equation, std::string error, size_t pos) {
-		error += " @ character " + std::to_string(pos) + '\n';
-		error += equation + '\n';
-		error += std::string(pos, ' ') + "^\n";
-		throw EvaluationException{error};
+	template class BasicEvaluator<int>;
+	template class BasicEvaluator<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	template class BasicEvaluator<__int128>;
+#endif
+	template class BasicEvaluator<double>;
+
+	void throw_annotated(std::string_view equation, std::string_view error, size_t pos) {
+		throw EvaluationException{annotate(equation, error, pos)};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,134 @@
+// STD
+#include <algorithm>
+#include <mutex>
+
+// InfixParser
+#include <InfixParser/ExpressionCache.hpp>
+#include <InfixParser/Evaluator.hpp>
+
+namespace {
+	/**
+	 * @brief Get the counter stripe used by the current thread.
+	 * @return The counter stripe used by the current thread.
+	 */
+	size_t stripe_index() {
+		static std::atomic<size_t> next_stripe{0};
+		thread_local const size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed);
+		return stripe;
+	}
+}
+
+namespace InfixParser {
+	ExpressionCache::ExpressionCache(size_t capacity, size_t shards) {
+		// Round the number of shards up to a power of two so that a shard can be selected with a mask
+		size_t count = 1;
+
+		while (count < shards) {
+			count *= 2;
+		}
+
+		shard_capacity = std::max<size_t>(1, (capacity + count - 1) / count);
+		this->shards = std::vector<Shard>(count);
+	}
+
+	std::shared_ptr<const CompiledExpression> ExpressionCache::get(const std::string& equation) {
+		auto& shard = shards[std::hash<std::string>{}(equation) & (shards.size() - 1)];
+
+		// Look for an existing expression
+		{
+			std::shared_lock<std::shared_mutex> lock{shard.mutex};
+			auto found = shard.entries.find(equation);
+
+			if (found != shard.entries.end()) {
+				auto& entry = found->second;
+
+				// Avoid writing to the entry when it is already marked
+				if (!entry.referenced.load(std::memory_order_relaxed)) {
+					entry.referenced.store(true, std::memory_order_relaxed);
+				}
+
+				hits.increment();
+				return entry.expression;
+			}
+		}
+
+		// Compile the expression without holding the lock
+		misses.increment();
+
+		thread_local Evaluator evaluator;
+		auto expression = std::make_shared<const CompiledExpression>(evaluator.compile(equation));
+
+		// Another thread may have inserted the same expression while we were compiling
+		std::unique_lock<std::shared_mutex> lock{shard.mutex};
+		auto found = shard.entries.find(equation);
+
+		if (found != shard.entries.end()) {
+			return found->second.expression;
+		}
+
+		insert(shard, equation, expression);
+		return expression;
+	}
+
+	ExpressionCache::Statistics ExpressionCache::statistics() const {
+		Statistics stats = {hits.value(), misses.value(), evictions.value(), 0};
+
+		for (const auto& shard : shards) {
+			std::shared_lock<std::shared_mutex> lock{shard.mutex};
+			stats.size += shard.entries.size();
+		}
+
+		return stats;
+	}
+
+	void ExpressionCache::clear() {
+		for (auto& shard : shards) {
+			std::unique_lock<std::shared_mutex> lock{shard.mutex};
+			shard.clock.clear();
+			shard.entries.clear();
+			shard.hand = 0;
+		}
+	}
+
+	ExpressionCache& ExpressionCache::global() {
+		static ExpressionCache cache{65536};
+		return cache;
+	}
+
+	void ExpressionCache::insert(Shard& shard, const std::string& equation, std::shared_ptr<const CompiledExpression> expression) {
+		size_t slot = shard.clock.size();
+
+		if (shard.entries.size() >= shard_capacity) {
+			// Advance the hand past recently used entries until one that has not been used is found
+			while (shard.clock[shard.hand]->second.referenced.exchange(false, std::memory_order_relaxed)) {
+				shard.hand = (shard.hand + 1) % shard.clock.size();
+			}
+
+			slot = shard.hand;
+			shard.hand = (shard.hand + 1) % shard.clock.size();
+
+			shard.entries.erase(shard.clock[slot]->first);
+			evictions.increment();
+		} else {
+			shard.clock.push_back(nullptr);
+		}
+
+		auto& element = *shard.entries.try_emplace(equation).first;
+		element.second.expression = std::move(expression);
+		shard.clock[slot] = &element;
+	}
+
+	void ExpressionCache::Counter::increment() {
+		stripes[stripe_index() % (sizeof(stripes) / sizeof(stripes[0]))].value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	uint64_t ExpressionCache::Counter::value() const {
+		uint64_t total = 0;
+
+		for (const auto& stripe : stripes) {
+			total += stripe.value.load(std::memory_order_relaxed);
+		}
+
+		return total;
+	}
+}
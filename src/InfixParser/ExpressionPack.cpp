@@ -0,0 +1,481 @@
+// STD
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+
+// InfixParser
+#include <InfixParser/ExpressionPack.hpp>
+#include <InfixParser/Evaluator.hpp>
+
+/*
+ * The layout of a pack. Every offset is from the start of the file and every value is in the byte order of the writer.
+ *
+ * Header                 The format, the value type it was written for and a checksum of everything after it
+ * Entry[count]           Where the parts of each expression are
+ * For each expression:
+ *   Operation[n + 1]     The operations interpret() runs, ending with Code::END
+ *   Record[n]            The type, operator and source position of each instruction
+ *   Name[names]          The variable names, followed by their characters
+ *   char[source_length]  The equation
+ */
+namespace {
+	// Identifies a pack and the version of its layout. The version changes whenever the layout,
+	// the interpreter's operation codes or the operator table below change.
+	constexpr char magic[8] = {'I', 'N', 'F', 'X', 'P', 'A', 'C', 'K'};
+	constexpr uint32_t version = 1;
+
+	// Read back in a different order when the writer had a different byte order
+	constexpr uint32_t byte_order = 0x01020304;
+
+	// Marks a record that does not apply an operator
+	constexpr uint8_t no_operator = 0xFF;
+
+	// The tag of each value type
+	template<class T>
+	constexpr uint32_t value_type() {
+		if constexpr (std::is_same_v<T, int>) {
+			return 1;
+		} else if constexpr (std::is_same_v<T, int64_t>) {
+			return 2;
+		} else if constexpr (std::is_same_v<T, double>) {
+			return 4;
+		} else {
+			return 3;
+		}
+	}
+
+	// The operators a pack can refer to, by their index. Only ever append to this table.
+	template<class T>
+	const std::array<const InfixParser::BasicOperator<T>*, 31>& packed_operators() {
+		using Operator = InfixParser::BasicOperator<T>;
+
+		static const std::array<const Operator*, 31> operators = {
+			&Operator::NEGATE, &Operator::NOT, &Operator::PRE_INCREMENT, &Operator::PRE_DECREMENT,
+			&Operator::POWER, &Operator::MULTIPLY, &Operator::DIVIDE, &Operator::REMAINDER, &Operator::ADD, &Operator::SUBTRACT,
+			&Operator::GREATER, &Operator::GREATER_OR_EQUAL, &Operator::LESS, &Operator::LESS_OR_EQUAL,
+			&Operator::EQUAL, &Operator::NOT_EQUAL, &Operator::AND, &Operator::OR,
+			&Operator::ABS, &Operator::MIN, &Operator::MAX, &Operator::CLAMP,
+			&Operator::CHECKED_NEGATE, &Operator::CHECKED_PRE_INCREMENT, &Operator::CHECKED_PRE_DECREMENT,
+			&Operator::CHECKED_POWER, &Operator::CHECKED_MULTIPLY, &Operator::CHECKED_DIVIDE,
+			&Operator::CHECKED_ADD, &Operator::CHECKED_SUBTRACT, &Operator::CHECKED_ABS,
+		};
+
+		return operators;
+	}
+
+	// FNV-1a over 64 bit words, so that checking a large pack does not dominate loading it
+	uint64_t checksum(const char* data, size_t size) {
+		constexpr uint64_t prime = 1099511628211ull;
+		uint64_t hash = 14695981039346656037ull;
+		size_t i = 0;
+
+		for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+			uint64_t word;
+			std::memcpy(&word, data + i, sizeof(word));
+			hash = (hash ^ word) * prime;
+		}
+
+		for (; i < size; ++i) {
+			hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+		}
+
+		return hash;
+	}
+
+	// Checks if value is a whole number in [0, limit]
+	template<class T>
+	bool is_index(T value, uint64_t limit) {
+		if (!(value >= 0) || value > static_cast<T>(limit)) { return false; }
+		return static_cast<T>(static_cast<uint64_t>(value)) == value;
+	}
+}
+
+namespace InfixParser {
+	template<class T>
+	struct BasicExpressionPack<T>::Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t byte_order;
+		uint32_t value_type;
+		uint32_t value_size;
+		uint32_t operation_size;
+		uint32_t operation_alignment;
+		uint64_t count;
+		uint64_t size;
+		uint64_t checksum;
+	};
+
+	template<class T>
+	struct BasicExpressionPack<T>::Entry {
+		uint64_t code;
+		uint64_t records;
+		uint64_t names;
+		uint64_t source;
+		uint32_t instructions;
+		uint32_t name_count;
+		uint32_t source_length;
+		uint32_t depth;
+	};
+
+	template<class T>
+	struct BasicExpressionPack<T>::Name {
+		uint64_t offset;
+		uint64_t length;
+	};
+
+	template<class T>
+	struct BasicExpressionPack<T>::Record {
+		uint32_t position;
+		uint8_t type;
+		uint8_t op;
+		uint8_t reserved[2];
+	};
+
+	template<class T>
+	BasicExpressionPack<T>::BasicExpressionPack(const std::string& path)
+		: file{path} {
+		const auto fail = [&](const std::string& reason) {
+			throw ExpressionPackException{"\"" + path + "\" " + reason};
+		};
+
+		Header header;
+
+		if (file.size() < sizeof(header)) {
+			fail("is not an expression pack.");
+		}
+
+		std::memcpy(&header, file.data(), sizeof(header));
+
+		if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+			fail("is not an expression pack.");
+		}
+
+		if (header.byte_order != byte_order) {
+			fail("was written on a platform with a different byte order.");
+		}
+
+		if (header.version != version) {
+			fail("has version " + std::to_string(header.version) + ", but only version " + std::to_string(version) + " is supported.");
+		}
+
+		if (header.value_type != value_type<T>() || header.value_size != sizeof(T)) {
+			fail("was written for a different value type.");
+		}
+
+		if (header.operation_size != sizeof(Operation) || header.operation_alignment != alignof(Operation)) {
+			fail("was written by an incompatible build.");
+		}
+
+		if (header.size != file.size()) {
+			fail("is truncated.");
+		}
+
+		if (header.checksum != checksum(file.data() + sizeof(header), file.size() - sizeof(header))) {
+			fail("is corrupt.");
+		}
+
+		if (header.count > (file.size() - sizeof(header)) / sizeof(Entry)) {
+			fail("is corrupt.");
+		}
+
+		entries = at<Entry>(sizeof(header));
+		count = static_cast<size_t>(header.count);
+
+		// The checksum only shows the file is as written, so check that every program is safe to run
+		std::vector<std::pair<uint32_t, uint32_t>> jumps;
+
+		for (size_t i = 0; i < count; ++i) {
+			validate(i, jumps);
+		}
+	}
+
+	template<class T>
+	void BasicExpressionPack<T>::write(const std::string& path, const std::vector<CompiledExpression>& expressions) {
+		const auto& operators = packed_operators<T>();
+		std::string buffer(sizeof(Header) + expressions.size() * sizeof(Entry), '\0');
+
+		// Adds zeroed space for bytes bytes aligned to alignment, so padding is always written the same
+		const auto reserve = [&](size_t alignment, size_t bytes) {
+			const auto offset = (buffer.size() + alignment - 1) / alignment * alignment;
+			buffer.resize(offset + bytes, '\0');
+			return static_cast<uint64_t>(offset);
+		};
+
+		for (size_t i = 0; i < expressions.size(); ++i) {
+			const auto& expression = expressions[i];
+			const auto& program = expression.program;
+			Entry entry = {};
+
+			entry.instructions = static_cast<uint32_t>(program.size());
+			entry.name_count = static_cast<uint32_t>(expression.names.size());
+			entry.source_length = static_cast<uint32_t>(expression.source.size());
+			entry.depth = static_cast<uint32_t>(expression.depth);
+
+			// The operations, field by field to leave their padding zeroed
+			entry.code = reserve(alignof(Operation), expression.code.size() * sizeof(Operation));
+
+			for (size_t j = 0; j < expression.code.size(); ++j) {
+				const auto operation = &buffer[entry.code + j * sizeof(Operation)];
+				std::memcpy(operation + offsetof(Operation, code), &expression.code[j].code, sizeof(Code));
+				std::memcpy(operation + offsetof(Operation, value), &expression.code[j].value, sizeof(T));
+			}
+
+			// The records
+			entry.records = reserve(alignof(Record), program.size() * sizeof(Record));
+
+			for (size_t j = 0; j < program.size(); ++j) {
+				Record record = {static_cast<uint32_t>(program[j].position), static_cast<uint8_t>(program[j].type), no_operator, {0, 0}};
+
+				if (program[j].type == Instruction::Type::OPERATOR) {
+					const auto found = std::find(operators.cbegin(), operators.cend(), program[j].op);
+
+					if (found == operators.cend()) {
+						throw ExpressionPackException{"The operator " + program[j].op->to_string() + " of \"" + expression.source + "\" is not predefined and cannot be saved."};
+					}
+
+					record.op = static_cast<uint8_t>(found - operators.cbegin());
+				}
+
+				std::memcpy(&buffer[entry.records + j * sizeof(Record)], &record, sizeof(record));
+			}
+
+			// The names and their characters
+			entry.names = reserve(alignof(Name), expression.names.size() * sizeof(Name));
+
+			for (size_t j = 0; j < expression.names.size(); ++j) {
+				const auto& name = expression.names[j];
+				const Name packed = {reserve(1, name.size()), name.size()};
+				std::memcpy(&buffer[packed.offset], name.data(), name.size());
+				std::memcpy(&buffer[entry.names + j * sizeof(Name)], &packed, sizeof(packed));
+			}
+
+			// The equation
+			entry.source = reserve(1, expression.source.size());
+			std::memcpy(&buffer[entry.source], expression.source.data(), expression.source.size());
+
+			std::memcpy(&buffer[sizeof(Header) + i * sizeof(Entry)], &entry, sizeof(entry));
+		}
+
+		Header header = {};
+		std::memcpy(header.magic, magic, sizeof(magic));
+		header.version = version;
+		header.byte_order = byte_order;
+		header.value_type = value_type<T>();
+		header.value_size = sizeof(T);
+		header.operation_size = sizeof(Operation);
+		header.operation_alignment = alignof(Operation);
+		header.count = expressions.size();
+		header.size = buffer.size();
+		header.checksum = checksum(buffer.data() + sizeof(header), buffer.size() - sizeof(header));
+		std::memcpy(&buffer[0], &header, sizeof(header));
+
+		std::ofstream output{path, std::ios::binary | std::ios::trunc};
+		output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+		if (!output) {
+			throw ExpressionPackException{"Unable to write \"" + path + "\"."};
+		}
+	}
+
+	template<class T>
+	BasicEvaluationResult<T> BasicExpressionPack<T>::try_run(size_t index, const T* values, BasicOperandStack<T>& operands) const {
+		const auto& current = entry(index);
+		const auto stack = operands.scratch(current.depth);
+
+		if (CompiledExpression::interpret(at<Operation>(current.code), values, stack) == current.instructions) {
+			return {stack[0]};
+		}
+
+		// Rebuild the instructions to find which operator failed and where
+		const auto program = instructions(current);
+		return CompiledExpression::execute(program.data(), program.data() + program.size(), values, operands);
+	}
+
+	template<class T>
+	T BasicExpressionPack<T>::run(size_t index, const T* values, BasicOperandStack<T>& operands) const {
+		const auto result = try_run(index, values, operands);
+
+		if (!result.ok()) {
+			throw EvaluationException{result.message(equation(index))};
+		}
+
+		return result.value;
+	}
+
+	template<class T>
+	BasicCompiledExpression<T> BasicExpressionPack<T>::expression(size_t index) const {
+		const auto& current = entry(index);
+		std::vector<std::string> names;
+
+		for (const auto name : variables(index)) {
+			names.emplace_back(name);
+		}
+
+		return {std::string{equation(index)}, instructions(current), std::move(names), current.depth};
+	}
+
+	template<class T>
+	std::string_view BasicExpressionPack<T>::equation(size_t index) const {
+		const auto& current = entry(index);
+		return {at<char>(current.source), current.source_length};
+	}
+
+	template<class T>
+	std::vector<std::string_view> BasicExpressionPack<T>::variables(size_t index) const {
+		const auto& current = entry(index);
+		const auto names = at<Name>(current.names);
+		std::vector<std::string_view> variables;
+
+		for (uint32_t i = 0; i < current.name_count; ++i) {
+			variables.emplace_back(at<char>(names[i].offset), static_cast<size_t>(names[i].length));
+		}
+
+		return variables;
+	}
+
+	template<class T>
+	size_t BasicExpressionPack<T>::size() const {
+		return count;
+	}
+
+	template<class T>
+	const typename BasicExpressionPack<T>::Entry& BasicExpressionPack<T>::entry(size_t index) const {
+		return entries[index];
+	}
+
+	template<class T>
+	template<class U>
+	const U* BasicExpressionPack<T>::at(uint64_t offset) const {
+		return reinterpret_cast<const U*>(file.data() + offset);
+	}
+
+	template<class T>
+	std::vector<BasicInstruction<T>> BasicExpressionPack<T>::instructions(const Entry& entry) const {
+		const auto& operators = packed_operators<T>();
+		const auto operations = at<Operation>(entry.code);
+		const auto records = at<Record>(entry.records);
+		std::vector<Instruction> program;
+		program.reserve(entry.instructions);
+
+		for (uint32_t i = 0; i < entry.instructions; ++i) {
+			const auto type = static_cast<typename Instruction::Type>(records[i].type);
+			const auto op = type == Instruction::Type::OPERATOR ? operators[records[i].op] : nullptr;
+			program.push_back({type, op, operations[i].value, records[i].position});
+		}
+
+		return program;
+	}
+
+	template<class T>
+	void BasicExpressionPack<T>::validate(size_t index, std::vector<std::pair<uint32_t, uint32_t>>& jumps) const {
+		const auto& current = entry(index);
+		const auto size = static_cast<uint64_t>(file.size());
+
+		const auto fail = [&] {
+			throw ExpressionPackException{"Expression " + std::to_string(index) + " of the expression pack is corrupt."};
+		};
+
+		// Checks that count objects of object_size bytes at offset are aligned and within the file
+		const auto check_range = [&](uint64_t offset, uint64_t count, size_t object_size, size_t alignment) {
+			if (offset > size || count > (size - offset) / object_size || offset % alignment != 0) {
+				fail();
+			}
+		};
+
+		check_range(current.code, uint64_t{current.instructions} + 1, sizeof(Operation), alignof(Operation));
+		check_range(current.records, current.instructions, sizeof(Record), alignof(Record));
+		check_range(current.names, current.name_count, sizeof(Name), alignof(Name));
+		check_range(current.source, current.source_length, 1, 1);
+
+		const auto names = at<Name>(current.names);
+
+		for (uint32_t i = 0; i < current.name_count; ++i) {
+			check_range(names[i].offset, names[i].length, 1, 1);
+		}
+
+		// The operation each packed operator is run as
+		static const auto codes = [] {
+			const auto& operators = packed_operators<T>();
+			std::array<Code, std::tuple_size_v<std::decay_t<decltype(operators)>>> codes;
+
+			for (size_t i = 0; i < operators.size(); ++i) {
+				codes[i] = CompiledExpression::encode({Instruction::Type::OPERATOR, operators[i], 0, 0}).code;
+			}
+
+			return codes;
+		}();
+
+		// Follow the height of the operand stack, which must never go below what an operation uses or above the depth
+		const auto operations = at<Operation>(current.code);
+		const auto records = at<Record>(current.records);
+		uint32_t height = 0;
+		jumps.clear();
+
+		for (uint32_t i = 0; i < current.instructions; ++i) {
+			// Both ways past a jump must leave the same operands
+			while (!jumps.empty() && jumps.back().first == i) {
+				if (jumps.back().second != height) { fail(); }
+				jumps.pop_back();
+			}
+
+			const auto& operation = operations[i];
+			const auto& record = records[i];
+
+			switch (static_cast<typename Instruction::Type>(record.type)) {
+				case Instruction::Type::VALUE:
+					if (operation.code != Code::VALUE) { fail(); }
+					++height;
+					break;
+				case Instruction::Type::VARIABLE:
+					if (operation.code != Code::VARIABLE || current.name_count == 0 || !is_index(operation.value, current.name_count - 1)) { fail(); }
+					++height;
+					break;
+				case Instruction::Type::JUMP_IF_FALSE:
+				case Instruction::Type::JUMP_IF_TRUE: {
+					const auto expected = record.type == static_cast<uint8_t>(Instruction::Type::JUMP_IF_FALSE) ? Code::JUMP_IF_FALSE : Code::JUMP_IF_TRUE;
+
+					if (operation.code != expected || height == 0 || !is_index(operation.value, current.instructions - i - 1)) { fail(); }
+
+					// Jumps nest, so each lands no later than the one it is inside of
+					const auto target = i + 1 + static_cast<uint32_t>(operation.value);
+					if (!jumps.empty() && target > jumps.back().first) { fail(); }
+
+					jumps.emplace_back(target, height);
+					break;
+				}
+				case Instruction::Type::OPERATOR: {
+					if (record.op >= codes.size() || operation.code != codes[record.op]) { fail(); }
+
+					const auto arity = static_cast<uint32_t>(packed_operators<T>()[record.op]->arity());
+					if (height < arity) { fail(); }
+
+					height = height - arity + 1;
+					break;
+				}
+				default:
+					fail();
+			}
+
+			if (height > current.depth) { fail(); }
+		}
+
+		while (!jumps.empty() && jumps.back().first == current.instructions && jumps.back().second == height) {
+			jumps.pop_back();
+		}
+
+		if (height != 1 || !jumps.empty() || operations[current.instructions].code != Code::END) {
+			fail();
+		}
+	}
+
+	template class BasicExpressionPack<int>;
+	template class BasicExpressionPack<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	template class BasicExpressionPack<__int128>;
+#endif
+	template class BasicExpressionPack<double>;
+}
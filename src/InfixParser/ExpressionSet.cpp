@@ -0,0 +1,372 @@
+// STD
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+// InfixParser
+#include <InfixParser/ExpressionSet.hpp>
+#include <InfixParser/Evaluator.hpp>
+
+namespace {
+	// Hashes the contents of a node, reading its value as bytes so that equal bits are equal values
+	template<class Node>
+	struct NodeHash {
+		size_t operator()(const Node& node) const {
+			unsigned char bytes[sizeof(node.value)];
+			std::memcpy(bytes, &node.value, sizeof(bytes));
+
+			// FNV-1a
+			uint64_t hash = 14695981039346656037ull;
+			const auto mix = [&](uint64_t word) { hash = (hash ^ word) * 1099511628211ull; };
+
+			mix(static_cast<uint64_t>(node.type));
+			mix(reinterpret_cast<uintptr_t>(node.op));
+
+			for (const auto byte : bytes) { mix(byte); }
+			for (const auto operand : node.operands) { mix(operand); }
+
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	template<class Node>
+	struct NodeEqual {
+		bool operator()(const Node& left, const Node& right) const {
+			return left.type == right.type
+				&& left.op == right.op
+				&& std::memcmp(&left.value, &right.value, sizeof(left.value)) == 0
+				&& std::equal(std::begin(left.operands), std::end(left.operands), std::begin(right.operands));
+		}
+	};
+
+	// Checks if the operands of op can be swapped without changing its result
+	// min and max return their left operand when the operands are unordered or are zeros of either sign, so they only commute for integers
+	template<class T>
+	bool is_commutative(const InfixParser::BasicOperator<T>* op) {
+		using Operator = InfixParser::BasicOperator<T>;
+
+		return op == &Operator::ADD || op == &Operator::MULTIPLY
+			|| op == &Operator::CHECKED_ADD || op == &Operator::CHECKED_MULTIPLY
+			|| op == &Operator::EQUAL || op == &Operator::NOT_EQUAL
+			|| op == &Operator::AND || op == &Operator::OR
+			|| (std::is_integral_v<T> && (op == &Operator::MIN || op == &Operator::MAX));
+	}
+}
+
+namespace InfixParser {
+	template<class T>
+	BasicExpressionSet<T>::BasicExpressionSet(std::vector<CompiledExpression> expressions)
+		: members{std::move(expressions)} {
+		std::unordered_map<Node, uint32_t, NodeHash<Node>, NodeEqual<Node>> index;
+		std::vector<uint32_t> stack;
+
+		// Reuse an equal node if there is one
+		const auto intern = [&](const Node& node) {
+			const auto [found, added] = index.try_emplace(node, static_cast<uint32_t>(nodes.size()));
+
+			if (added) {
+				nodes.push_back(node);
+			}
+
+			return found->second;
+		};
+
+		for (const auto& expression : members) {
+			// Give each variable the slot of its name, adding names not seen before
+			auto& expression_slots = slots.emplace_back();
+
+			for (const auto& name : expression.variables()) {
+				const auto found = std::find(names.cbegin(), names.cend(), name);
+				expression_slots.push_back(static_cast<size_t>(found - names.cbegin()));
+
+				if (found == names.cend()) {
+					names.push_back(name);
+				}
+			}
+
+			// Replay the program with nodes in place of values
+			stack.clear();
+
+			for (const auto& instruction : expression.instructions()) {
+				Node node = {instruction.type, nullptr, 0, {0, 0, 0}};
+
+				switch (instruction.type) {
+					case Instruction::Type::VALUE:
+						node.value = instruction.value;
+						break;
+					case Instruction::Type::VARIABLE:
+						node.value = static_cast<T>(expression_slots[static_cast<size_t>(instruction.value)]);
+						break;
+					case Instruction::Type::JUMP_IF_FALSE:
+					case Instruction::Type::JUMP_IF_TRUE:
+						// Both sides are always run, so && and || are plain operators here
+						continue;
+					case Instruction::Type::OPERATOR: {
+						const auto arity = static_cast<size_t>(instruction.op->arity());
+						node.op = instruction.op;
+
+						std::copy(stack.end() - arity, stack.end(), node.operands);
+						stack.resize(stack.size() - arity);
+
+						if (arity == 2 && is_commutative(node.op) && node.operands[1] < node.operands[0]) {
+							std::swap(node.operands[0], node.operands[1]);
+						}
+
+						++operation_count;
+						break;
+					}
+				}
+
+				stack.push_back(intern(node));
+			}
+
+			roots.push_back(stack.back());
+		}
+
+		plan();
+	}
+
+	template<class T>
+	void BasicExpressionSet<T>::plan() {
+		// Group the expressions by the node that computes their result
+		std::vector<std::vector<uint32_t>> results(nodes.size());
+
+		for (size_t expression = 0; expression < roots.size(); ++expression) {
+			results[roots[expression]].push_back(static_cast<uint32_t>(expression));
+		}
+
+		for (uint32_t i = 0; i < nodes.size(); ++i) {
+			if (nodes[i].type != Instruction::Type::OPERATOR) { continue; }
+
+			Step step = {i, {}, static_cast<uint32_t>(outputs.size()), static_cast<uint32_t>(results[i].size())};
+
+			// The kernels only operate on ints
+			if constexpr (std::is_same_v<T, int>) {
+				step.kernel = Kernels::find(nodes[i].op);
+			}
+
+			steps.push_back(step);
+			outputs.insert(outputs.end(), results[i].cbegin(), results[i].cend());
+		}
+
+		// Find the last step that reads each node
+		std::vector<size_t> last_use(nodes.size(), 0);
+
+		for (size_t i = 0; i < steps.size(); ++i) {
+			const auto& node = nodes[steps[i].node];
+			last_use[steps[i].node] = i;
+
+			for (int operand = 0; operand < node.op->arity(); ++operand) {
+				last_use[node.operands[operand]] = i;
+			}
+		}
+
+		// Variables are read from their columns, constants have a block of their own,
+		// and the result of each step takes a block that is free again after its last use
+		locations.resize(nodes.size());
+		std::vector<uint32_t> free;
+
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			if (nodes[i].type == Instruction::Type::VARIABLE) {
+				locations[i] = {true, static_cast<uint32_t>(nodes[i].value)};
+			} else if (nodes[i].type == Instruction::Type::VALUE) {
+				locations[i] = {false, static_cast<uint32_t>(blocks++)};
+			}
+		}
+
+		for (size_t i = 0; i < steps.size(); ++i) {
+			const auto& node = nodes[steps[i].node];
+
+			if (free.empty()) {
+				locations[steps[i].node] = {false, static_cast<uint32_t>(blocks++)};
+			} else {
+				locations[steps[i].node] = {false, free.back()};
+				free.pop_back();
+			}
+
+			for (int operand = 0; operand < node.op->arity(); ++operand) {
+				const auto input = node.operands[operand];
+				const auto repeated = std::find(node.operands, node.operands + operand, input) != node.operands + operand;
+
+				if (nodes[input].type == Instruction::Type::OPERATOR && last_use[input] == i && !repeated) {
+					free.push_back(locations[input].index);
+				}
+			}
+
+			// Results no step reads are only copied out
+			if (last_use[steps[i].node] == i) {
+				free.push_back(locations[steps[i].node].index);
+			}
+		}
+	}
+
+	template<class T>
+	void BasicExpressionSet<T>::run(const T* values, T* results) const {
+		// A single row is a batch whose columns are the values
+		std::vector<const T*> columns(names.size());
+		std::vector<T*> outputs(members.size());
+
+		for (size_t i = 0; i < columns.size(); ++i) {
+			columns[i] = values + i;
+		}
+
+		for (size_t i = 0; i < outputs.size(); ++i) {
+			outputs[i] = results + i;
+		}
+
+		std::vector<T> storage(blocks);
+		OperandStack operands;
+		fill_constants(storage.data(), 1);
+
+		if (run_block(columns.data(), outputs.data(), 0, 1, storage.data(), 1, operands)) {
+			return;
+		}
+
+		// Let each expression report its own error
+		std::vector<T> expression_values;
+
+		for (size_t expression = 0; expression < members.size(); ++expression) {
+			expression_values.clear();
+
+			for (const auto slot : slots[expression]) {
+				expression_values.push_back(values[slot]);
+			}
+
+			results[expression] = members[expression].run(expression_values.data(), operands);
+		}
+	}
+
+	template<class T>
+	void BasicExpressionSet<T>::run_batch(const T* const* columns, T* const* results, size_t rows) const {
+		if (rows == 0) { return; }
+
+		const auto stride = std::min(rows, block_size);
+		std::vector<T> storage(blocks * stride);
+		OperandStack operands;
+		fill_constants(storage.data(), stride);
+
+		for (size_t offset = 0; offset < rows; offset += block_size) {
+			const auto count = std::min(block_size, rows - offset);
+
+			if (!run_block(columns, results, offset, count, storage.data(), stride, operands)) {
+				run_separately(columns, results, offset, count);
+			}
+		}
+	}
+
+	template<class T>
+	const std::vector<std::string>& BasicExpressionSet<T>::variables() const {
+		return names;
+	}
+
+	template<class T>
+	const std::vector<BasicCompiledExpression<T>>& BasicExpressionSet<T>::expressions() const {
+		return members;
+	}
+
+	template<class T>
+	typename BasicExpressionSet<T>::Statistics BasicExpressionSet<T>::statistics() const {
+		return {members.size(), operation_count, steps.size(), nodes.size()};
+	}
+
+	template<class T>
+	void BasicExpressionSet<T>::fill_constants(T* storage, size_t stride) const {
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			if (nodes[i].type == Instruction::Type::VALUE) {
+				const auto block = storage + locations[i].index * stride;
+				std::fill(block, block + stride, nodes[i].value);
+			}
+		}
+	}
+
+	template<class T>
+	bool BasicExpressionSet<T>::run_block(const T* const* columns, T* const* results, size_t offset, size_t count, T* storage, size_t stride, OperandStack& operands) const {
+		// The values of a node for the rows in the block
+		const auto values = [&](uint32_t node) -> const T* {
+			const auto& location = locations[node];
+			return location.column ? columns[location.index] + offset : storage + location.index * stride;
+		};
+
+		// Expressions that are a single constant or variable have no step
+		for (size_t expression = 0; expression < roots.size(); ++expression) {
+			if (nodes[roots[expression]].type != Instruction::Type::OPERATOR) {
+				const auto source = values(roots[expression]);
+				std::copy(source, source + count, results[expression] + offset);
+			}
+		}
+
+		for (const auto& step : steps) {
+			const auto& node = nodes[step.node];
+			const auto arity = static_cast<size_t>(node.op->arity());
+			const auto target = storage + locations[step.node].index * stride;
+			size_t applied = 0;
+
+			if constexpr (std::is_same_v<T, int>) {
+				if (step.kernel.unary) {
+					std::copy(values(node.operands[0]), values(node.operands[0]) + count, target);
+					applied = step.kernel.unary(target, count);
+				} else if (step.kernel.binary) {
+					std::copy(values(node.operands[0]), values(node.operands[0]) + count, target);
+					applied = step.kernel.binary(target, values(node.operands[1]), count);
+				} else if (step.kernel.ternary) {
+					std::copy(values(node.operands[0]), values(node.operands[0]) + count, target);
+					applied = step.kernel.ternary(target, values(node.operands[1]), values(node.operands[2]), count);
+				}
+			}
+
+			// Apply the operator to the rows without a kernel, giving up on the block at the first error
+			for (auto row = applied; row < count; ++row) {
+				operands.clear();
+
+				for (size_t operand = 0; operand < arity; ++operand) {
+					operands.push(values(node.operands[operand])[row]);
+				}
+
+				if (node.op->apply(operands) != Error::NONE) {
+					return false;
+				}
+
+				target[row] = operands.top();
+			}
+
+			for (auto output = step.first_output; output < step.first_output + step.output_count; ++output) {
+				std::copy(target, target + count, results[outputs[output]] + offset);
+			}
+		}
+
+		return true;
+	}
+
+	template<class T>
+	void BasicExpressionSet<T>::run_separately(const T* const* columns, T* const* results, size_t offset, size_t count) const {
+		std::vector<T> values;
+		OperandStack operands;
+
+		for (auto row = offset; row < offset + count; ++row) {
+			for (size_t expression = 0; expression < members.size(); ++expression) {
+				const auto& member = members[expression];
+				values.clear();
+
+				for (const auto slot : slots[expression]) {
+					values.push_back(columns[slot][row]);
+				}
+
+				const auto result = member.try_run(values.data(), operands);
+
+				if (!result.ok()) {
+					throw_annotated(member.equation(), result.description(member.equation()) + " (row " + std::to_string(row) + ")", result.position);
+				}
+
+				results[expression][row] = result.value;
+			}
+		}
+	}
+
+	template class BasicExpressionSet<int>;
+	template class BasicExpressionSet<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	template class BasicExpressionSet<__int128>;
+#endif
+	template class BasicExpressionSet<double>;
+}
@@ -0,0 +1,299 @@
+// STD
+#include <algorithm>
+
+// InfixParser
+#include <InfixParser/FormulaGraph.hpp>
+
+namespace {
+	// Waves smaller than this are run on the calling thread, since splitting them costs more than it saves
+	constexpr size_t parallel_wave = 1024;
+
+	// The number of formulas each worker runs at a time
+	constexpr size_t wave_grain = 256;
+}
+
+namespace InfixParser {
+	FormulaGraph::FormulaGraph(ThreadPool& pool)
+		: pool{&pool}
+		, scratch(pool.size()) {
+	}
+
+	void FormulaGraph::define(const std::string& name, std::string_view equation) {
+		auto expression = std::make_unique<const CompiledExpression>(evaluator.compile(equation));
+		const auto& variables = expression->variables();
+		const auto found = index.find(name);
+
+		// Reject the formula before changing anything. Names that do not exist yet cannot lead back to it.
+		if (found == index.end()) {
+			if (std::find(variables.cbegin(), variables.cend(), name) != variables.cend()) {
+				throw FormulaGraphException{"Defining \"" + name + "\" creates a cycle: " + name + " -> " + name};
+			}
+		} else {
+			std::vector<size_t> inputs;
+
+			for (const auto& variable : variables) {
+				if (const auto input = index.find(variable); input != index.end()) {
+					inputs.push_back(input->second);
+				}
+			}
+
+			if (const auto cycle = find_cycle(found->second, inputs); !cycle.empty()) {
+				throw FormulaGraphException{"Defining \"" + name + "\" creates a cycle: " + cycle};
+			}
+		}
+
+		const auto node = find_or_add(name);
+		unlink(node);
+
+		for (const auto& variable : variables) {
+			const auto input = find_or_add(variable);
+			nodes[node].inputs.push_back(input);
+			nodes[input].dependents.push_back(node);
+		}
+
+		nodes[node].expression = std::move(expression);
+		nodes[node].stale = true;
+		pending.push_back(node);
+	}
+
+	void FormulaGraph::set(const std::string& name, int value) {
+		const auto node = find_or_add(name);
+		auto& current = nodes[node];
+
+		// Setting an input to the value it has changes nothing downstream
+		if (!current.expression && current.result.ok() && current.result.value == value) {
+			return;
+		}
+
+		unlink(node);
+		current.expression.reset();
+		current.result = {value};
+		current.origin = node;
+		current.stale = true;
+		pending.push_back(node);
+	}
+
+	void FormulaGraph::recompute() {
+		recomputed_count = 0;
+
+		if (pending.empty()) { return; }
+
+		// Find every node downstream of a change, and count how many of the inputs of each are recomputed before it
+		const auto traversal = ++epoch;
+		affected.clear();
+
+		for (const auto node : pending) {
+			if (nodes[node].visited != traversal) {
+				nodes[node].visited = traversal;
+				nodes[node].remaining = 0;
+				affected.push_back(node);
+			}
+		}
+
+		pending.clear();
+
+		for (size_t i = 0; i < affected.size(); ++i) {
+			for (const auto dependent : nodes[affected[i]].dependents) {
+				if (nodes[dependent].visited != traversal) {
+					nodes[dependent].visited = traversal;
+					nodes[dependent].remaining = 0;
+					affected.push_back(dependent);
+				}
+
+				++nodes[dependent].remaining;
+			}
+		}
+
+		// Run the nodes a wave at a time. Nodes in the same wave never depend on each other.
+		wave.clear();
+
+		for (const auto node : affected) {
+			if (nodes[node].remaining == 0) {
+				wave.push_back(node);
+			}
+		}
+
+		for (auto& worker : scratch) {
+			worker.recomputed = 0;
+		}
+
+		while (!wave.empty()) {
+			if (wave.size() < parallel_wave) {
+				for (const auto node : wave) {
+					run(node, scratch.back());
+				}
+			} else {
+				pool->run(wave.size(), wave_grain, [&](size_t worker, size_t begin, size_t end) {
+					for (auto i = begin; i < end; ++i) {
+						run(wave[i], scratch[worker]);
+					}
+				});
+			}
+
+			next_wave.clear();
+
+			for (const auto node : wave) {
+				for (const auto dependent : nodes[node].dependents) {
+					if (--nodes[dependent].remaining == 0) {
+						next_wave.push_back(dependent);
+					}
+				}
+			}
+
+			std::swap(wave, next_wave);
+		}
+
+		for (const auto& worker : scratch) {
+			recomputed_count += worker.recomputed;
+		}
+	}
+
+	EvaluationResult FormulaGraph::result(const std::string& name) const {
+		return find(name).result;
+	}
+
+	int FormulaGraph::value(const std::string& name) const {
+		const auto& node = find(name);
+
+		if (!node.result.ok()) {
+			// The error is described relative to the formula it occurred in
+			const auto& origin = nodes[node.origin];
+			throw EvaluationException{origin.expression ? node.result.message(origin.expression->equation()) : to_string(node.result.error)};
+		}
+
+		return node.result.value;
+	}
+
+	bool FormulaGraph::contains(const std::string& name) const {
+		return index.find(name) != index.end();
+	}
+
+	size_t FormulaGraph::size() const {
+		return nodes.size();
+	}
+
+	size_t FormulaGraph::recomputed() const {
+		return recomputed_count;
+	}
+
+	size_t FormulaGraph::find_or_add(const std::string& name) {
+		const auto [found, added] = index.try_emplace(name, nodes.size());
+
+		if (added) {
+			auto& node = nodes.emplace_back();
+			node.name = name;
+			node.origin = found->second;
+		}
+
+		return found->second;
+	}
+
+	const FormulaGraph::Node& FormulaGraph::find(const std::string& name) const {
+		const auto found = index.find(name);
+
+		if (found == index.end()) {
+			throw FormulaGraphException{"Unknown formula \"" + name + "\"."};
+		}
+
+		return nodes[found->second];
+	}
+
+	void FormulaGraph::unlink(size_t node) {
+		for (const auto input : nodes[node].inputs) {
+			auto& dependents = nodes[input].dependents;
+			dependents.erase(std::find(dependents.begin(), dependents.end(), node));
+		}
+
+		nodes[node].inputs.clear();
+	}
+
+	std::string FormulaGraph::find_cycle(size_t node, const std::vector<size_t>& inputs) {
+		// Search upstream from the new inputs for the node being defined, remembering the way back
+		const auto traversal = ++epoch;
+		std::unordered_map<size_t, size_t> parents;
+		std::vector<size_t> stack;
+
+		for (const auto input : inputs) {
+			if (nodes[input].visited != traversal) {
+				nodes[input].visited = traversal;
+				parents[input] = node;
+				stack.push_back(input);
+			}
+		}
+
+		while (!stack.empty()) {
+			const auto current = stack.back();
+			stack.pop_back();
+
+			if (current == node) {
+				// Follow the way back to the input the node was reached from
+				std::vector<size_t> path;
+
+				for (auto step = parents[node]; step != node; step = parents[step]) {
+					path.push_back(step);
+				}
+
+				auto cycle = nodes[node].name;
+
+				for (auto step = path.crbegin(); step != path.crend(); ++step) {
+					cycle += " -> " + nodes[*step].name;
+				}
+
+				return cycle + " -> " + nodes[node].name;
+			}
+
+			for (const auto input : nodes[current].inputs) {
+				if (nodes[input].visited != traversal) {
+					nodes[input].visited = traversal;
+					parents[input] = current;
+					stack.push_back(input);
+				}
+			}
+		}
+
+		return {};
+	}
+
+	void FormulaGraph::run(size_t index, Scratch& scratch) {
+		auto& node = nodes[index];
+		const auto stale = node.stale;
+		node.stale = false;
+		node.changed = stale;
+
+		if (!node.expression) { return; }
+
+		// Inputs outside of this recompute did not change
+		const auto input_changed = std::any_of(node.inputs.cbegin(), node.inputs.cend(), [&](size_t input) {
+			return nodes[input].visited == epoch && nodes[input].changed;
+		});
+
+		if (!stale && !input_changed) { return; }
+
+		++scratch.recomputed;
+
+		// A failed input fails the formula without running it
+		EvaluationResult result;
+		auto origin = index;
+		scratch.values.clear();
+
+		for (const auto input : node.inputs) {
+			const auto& input_node = nodes[input];
+
+			if (!input_node.result.ok()) {
+				result = input_node.result;
+				origin = input_node.origin;
+				break;
+			}
+
+			scratch.values.push_back(input_node.result.value);
+		}
+
+		if (origin == index) {
+			result = node.expression->try_run(scratch.values.data(), scratch.operands);
+		}
+
+		node.changed = result.value != node.result.value || result.error != node.result.error || origin != node.origin;
+		node.result = result;
+		node.origin = origin;
+	}
+}
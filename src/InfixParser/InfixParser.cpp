@@ -1,24 +1,109 @@
+// STD
+#include <charconv>
+#include <cstdint>
+#include <type_traits>
+
+// InfixParser
 #include <InfixParser/InfixParser.hpp>
+#include <InfixParser/Arithmetic.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#define INFIXPARSER_SCAN_SSE2
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace {
+#if defined(INFIXPARSER_SCAN_SSE2)
+	/**
+	 * @brief Get the index of the lowest set bit in @p value. @p value must not be zero.
+	 */
+	unsigned int lowest_bit(unsigned int value) {
+	#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, value);
+		return index;
+	#else
+		return __builtin_ctz(value);
+	#endif
+	}
+
+	/**
+	 * @brief Finds the first character in [@p begin, @p end) that is not in the class detected by @p classify.
+	 * Sixteen characters are classified at a time, with a scalar loop for the remainder.
+	 *
+	 * @param[in] begin The beginning of the string.
+	 * @param[in] end The end of the string.
+	 * @param[in] classify Returns a byte mask of the characters in the class.
+	 * @param[in] mask The character classes for the scalar loop.
+	 */
+	template<class Classify>
+	const char* skip_class(const char* begin, const char* end, Classify classify, uint8_t mask) {
+		while (end - begin >= 16) {
+			const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+			const auto outside = ~static_cast<unsigned int>(_mm_movemask_epi8(classify(chunk))) & 0xFFFF;
+
+			if (outside) {
+				return begin + lowest_bit(outside);
+			}
 
-bool InfixParser::is_number(char value) {
-	return (value >= '0') && (value <= '9');
+			begin += 16;
+		}
+
+		while (begin != end && InfixParser::Lexer::has_class(*begin, mask)) {
+			++begin;
+		}
+
+		return begin;
+	}
+#endif
 }
 
-bool InfixParser::is_whitespace(char value) {
-	return (value == ' ') || (value == '\t');
+const char* InfixParser::skip_whitespace(const char* begin, const char* end) {
+#if defined(INFIXPARSER_SCAN_SSE2)
+	return skip_class(begin, end, [](__m128i chunk) {
+		return _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')));
+	}, InfixParser::Lexer::WHITESPACE);
+#else
+	while (begin != end && is_whitespace(*begin)) { ++begin; }
+	return begin;
+#endif
 }
 
-int InfixParser::read_number(std::string::const_iterator& begin, std::string::const_iterator end) {
-	std::string num;
-	
-	// Read until the first non-number character
-	while (begin != end) {
-		if (!is_number(*begin)) { break; }
+const char* InfixParser::skip_number(const char* begin, const char* end) {
+#if defined(INFIXPARSER_SCAN_SSE2)
+	return skip_class(begin, end, [](__m128i chunk) {
+		// Characters above 127 are negative and so are never digits
+		return _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1)));
+	}, InfixParser::Lexer::DIGIT);
+#else
+	while (begin != end && is_number(*begin)) { ++begin; }
+	return begin;
+#endif
+}
 
-		num += *begin;
-		++begin;
-	}
+template<class T>
+bool InfixParser::read_number(const char*& begin, const char* end, T& value) {
+	const auto number_end = skip_number(begin, end);
 
-	// Convert the number string to an integer
-	return std::stoi(num);
+	// Let the standard library round to the nearest double
+	if constexpr (std::is_floating_point_v<T>) {
+		const auto result = std::from_chars(begin, number_end, value);
+		begin = number_end;
+		return result.ec == std::errc{};
+	} else {
+		const auto fits = Arithmetic::from_digits(begin, number_end, value);
+		begin = number_end;
+		return fits;
+	}
 }
+
+template bool InfixParser::read_number(const char*& begin, const char* end, int& value);
+template bool InfixParser::read_number(const char*& begin, const char* end, int64_t& value);
+#if defined(INFIXPARSER_INT128)
+template bool InfixParser::read_number(const char*& begin, const char* end, __int128& value);
+#endif
+template bool InfixParser::read_number(const char*& begin, const char* end, double& value);
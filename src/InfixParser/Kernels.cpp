@@ -0,0 +1,443 @@
+// STD
+#include <algorithm>
+
+// InfixParser
+#include <InfixParser/Kernels.hpp>
+#include <InfixParser/Arithmetic.hpp>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define INFIXPARSER_KERNELS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#if defined(__SSSE3__)
+		#include <tmmintrin.h>
+	#endif
+	#if defined(__SSE4_1__)
+		#include <smmintrin.h>
+	#endif
+	#define INFIXPARSER_KERNELS_SSE
+#endif
+
+namespace {
+	// The vector primitives the kernels are built from. Comparisons produce masks of all ones or all zeros.
+#if defined(INFIXPARSER_KERNELS_AVX2)
+	using Vector = __m256i;
+	constexpr size_t lanes = 8;
+
+	Vector load(const int* values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)); }
+	void store(int* values, Vector v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(values), v); }
+	Vector broadcast(int value) { return _mm256_set1_epi32(value); }
+	Vector add(Vector a, Vector b) { return _mm256_add_epi32(a, b); }
+	Vector subtract(Vector a, Vector b) { return _mm256_sub_epi32(a, b); }
+	Vector multiply(Vector a, Vector b) { return _mm256_mullo_epi32(a, b); }
+	Vector greater(Vector a, Vector b) { return _mm256_cmpgt_epi32(a, b); }
+	Vector equal(Vector a, Vector b) { return _mm256_cmpeq_epi32(a, b); }
+	Vector bit_and(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+	Vector bit_or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+	Vector and_not(Vector a, Vector b) { return _mm256_andnot_si256(a, b); }
+	Vector minimum(Vector a, Vector b) { return _mm256_min_epi32(a, b); }
+	Vector maximum(Vector a, Vector b) { return _mm256_max_epi32(a, b); }
+	Vector absolute(Vector v) { return _mm256_abs_epi32(v); }
+#elif defined(INFIXPARSER_KERNELS_SSE)
+	using Vector = __m128i;
+	constexpr size_t lanes = 4;
+
+	Vector load(const int* values) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values)); }
+	void store(int* values, Vector v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(values), v); }
+	Vector broadcast(int value) { return _mm_set1_epi32(value); }
+	Vector add(Vector a, Vector b) { return _mm_add_epi32(a, b); }
+	Vector subtract(Vector a, Vector b) { return _mm_sub_epi32(a, b); }
+	Vector greater(Vector a, Vector b) { return _mm_cmpgt_epi32(a, b); }
+	Vector equal(Vector a, Vector b) { return _mm_cmpeq_epi32(a, b); }
+	Vector bit_and(Vector a, Vector b) { return _mm_and_si128(a, b); }
+	Vector bit_or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+	Vector and_not(Vector a, Vector b) { return _mm_andnot_si128(a, b); }
+
+	Vector minimum(Vector a, Vector b) {
+	#if defined(__SSE4_1__)
+		return _mm_min_epi32(a, b);
+	#else
+		// SSE2 only has a 16 bit minimum, so select the smaller lanes with a comparison
+		const auto mask = greater(a, b);
+		return bit_or(bit_and(mask, b), and_not(mask, a));
+	#endif
+	}
+
+	Vector maximum(Vector a, Vector b) {
+	#if defined(__SSE4_1__)
+		return _mm_max_epi32(a, b);
+	#else
+		const auto mask = greater(a, b);
+		return bit_or(bit_and(mask, a), and_not(mask, b));
+	#endif
+	}
+
+	Vector absolute(Vector v) {
+	#if defined(__SSSE3__)
+		return _mm_abs_epi32(v);
+	#else
+		// Flip the bits of negative lanes and add one
+		const auto sign = _mm_srai_epi32(v, 31);
+		return subtract(_mm_xor_si128(v, sign), sign);
+	#endif
+	}
+
+	Vector multiply(Vector a, Vector b) {
+	#if defined(__SSE4_1__)
+		return _mm_mullo_epi32(a, b);
+	#else
+		// SSE2 only has a 32x32->64 multiply of the even lanes, so multiply the even and odd lanes separately
+		const auto even = _mm_mul_epu32(a, b);
+		const auto odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	#endif
+	}
+#else
+	using Vector = int;
+	constexpr size_t lanes = 1;
+
+	Vector load(const int* values) { return *values; }
+	void store(int* values, Vector v) { *values = v; }
+	Vector broadcast(int value) { return value; }
+	Vector add(Vector a, Vector b) { return InfixParser::Arithmetic::add(a, b); }
+	Vector subtract(Vector a, Vector b) { return InfixParser::Arithmetic::subtract(a, b); }
+	Vector multiply(Vector a, Vector b) { return InfixParser::Arithmetic::multiply(a, b); }
+	Vector greater(Vector a, Vector b) { return -(a > b); }
+	Vector equal(Vector a, Vector b) { return -(a == b); }
+	Vector bit_and(Vector a, Vector b) { return a & b; }
+	Vector bit_or(Vector a, Vector b) { return a | b; }
+	Vector and_not(Vector a, Vector b) { return ~a & b; }
+	Vector minimum(Vector a, Vector b) { return InfixParser::Arithmetic::minimum(a, b); }
+	Vector maximum(Vector a, Vector b) { return InfixParser::Arithmetic::maximum(a, b); }
+	Vector absolute(Vector v) { return InfixParser::Arithmetic::absolute(v); }
+#endif
+
+	// Converts a mask to 0 or 1
+	Vector to_bool(Vector mask) { return bit_and(mask, broadcast(1)); }
+
+	// Converts the inverse of a mask to 0 or 1
+	Vector to_bool_not(Vector mask) { return and_not(mask, broadcast(1)); }
+
+	template<class Function>
+	size_t transform(int* values, size_t count, Function function) {
+		size_t i = 0;
+
+		for (; i + lanes <= count; i += lanes) {
+			store(values + i, function(load(values + i)));
+		}
+
+		// Handle the remaining values through a padded buffer
+		if (i < count) {
+			int buffer[lanes] = {};
+			std::copy(values + i, values + count, buffer);
+			store(buffer, function(load(buffer)));
+			std::copy(buffer, buffer + (count - i), values + i);
+		}
+
+		return count;
+	}
+
+	// Applies a checked operation to each value until one overflows. Function returns true on overflow.
+	template<class Function>
+	size_t checked_transform(int* values, size_t count, Function function) {
+		for (size_t i = 0; i < count; ++i) {
+			int result;
+			if (function(values[i], result)) { return i; }
+			values[i] = result;
+		}
+
+		return count;
+	}
+
+	// Applies a checked operation to each pair until one overflows or fails. Function returns true on failure.
+	template<class Function>
+	size_t checked_transform(int* left, const int* right, size_t count, Function function) {
+		for (size_t i = 0; i < count; ++i) {
+			int result;
+			if (function(left[i], right[i], result)) { return i; }
+			left[i] = result;
+		}
+
+		return count;
+	}
+
+	template<class Function>
+	size_t transform(int* left, const int* right, size_t count, Function function) {
+		size_t i = 0;
+
+		for (; i + lanes <= count; i += lanes) {
+			store(left + i, function(load(left + i), load(right + i)));
+		}
+
+		// Handle the remaining values through padded buffers
+		if (i < count) {
+			int buffer_left[lanes] = {};
+			int buffer_right[lanes] = {};
+			std::copy(left + i, left + count, buffer_left);
+			std::copy(right + i, right + count, buffer_right);
+			store(buffer_left, function(load(buffer_left), load(buffer_right)));
+			std::copy(buffer_left, buffer_left + (count - i), left + i);
+		}
+
+		return count;
+	}
+
+	template<class Function>
+	size_t transform(int* first, const int* second, const int* third, size_t count, Function function) {
+		size_t i = 0;
+
+		for (; i + lanes <= count; i += lanes) {
+			store(first + i, function(load(first + i), load(second + i), load(third + i)));
+		}
+
+		// Handle the remaining values through padded buffers
+		if (i < count) {
+			int buffer_first[lanes] = {};
+			int buffer_second[lanes] = {};
+			int buffer_third[lanes] = {};
+			std::copy(first + i, first + count, buffer_first);
+			std::copy(second + i, second + count, buffer_second);
+			std::copy(third + i, third + count, buffer_third);
+			store(buffer_first, function(load(buffer_first), load(buffer_second), load(buffer_third)));
+			std::copy(buffer_first, buffer_first + (count - i), first + i);
+		}
+
+		return count;
+	}
+
+	// Unary kernels
+	size_t negate(int* values, size_t count) {
+		return transform(values, count, [](Vector v) { return subtract(broadcast(0), v); });
+	}
+
+	size_t logical_not(int* values, size_t count) {
+		return transform(values, count, [](Vector v) { return to_bool(equal(v, broadcast(0))); });
+	}
+
+	size_t pre_increment(int* values, size_t count) {
+		return transform(values, count, [](Vector v) { return add(v, broadcast(1)); });
+	}
+
+	size_t pre_decrement(int* values, size_t count) {
+		return transform(values, count, [](Vector v) { return subtract(v, broadcast(1)); });
+	}
+
+	size_t absolute(int* values, size_t count) {
+		return transform(values, count, [](Vector v) { return absolute(v); });
+	}
+
+	// Binary kernels
+	size_t power(int* left, const int* right, size_t count) {
+		for (size_t i = 0; i < count; ++i) {
+			if (left[i] == 0 && right[i] < 0) { return i; }
+			left[i] = InfixParser::Arithmetic::power(left[i], right[i]);
+		}
+
+		return count;
+	}
+
+	size_t multiply(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return multiply(a, b); });
+	}
+
+	size_t divide(int* left, const int* right, size_t count) {
+		for (size_t i = 0; i < count; ++i) {
+			if (right[i] == 0) { return i; }
+			left[i] = InfixParser::Arithmetic::divide(left[i], right[i]);
+		}
+
+		return count;
+	}
+
+	size_t remainder(int* left, const int* right, size_t count) {
+		for (size_t i = 0; i < count; ++i) {
+			if (right[i] == 0) { return i; }
+			left[i] = InfixParser::Arithmetic::remainder(left[i], right[i]);
+		}
+
+		return count;
+	}
+
+	size_t add(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return add(a, b); });
+	}
+
+	size_t subtract(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return subtract(a, b); });
+	}
+
+	size_t greater(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return to_bool(greater(a, b)); });
+	}
+
+	size_t greater_or_equal(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return to_bool_not(greater(b, a)); });
+	}
+
+	size_t less(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return to_bool(greater(b, a)); });
+	}
+
+	size_t less_or_equal(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return to_bool_not(greater(a, b)); });
+	}
+
+	size_t equal(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return to_bool(equal(a, b)); });
+	}
+
+	size_t not_equal(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return to_bool_not(equal(a, b)); });
+	}
+
+	size_t logical_and(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) {
+			const auto zero = broadcast(0);
+			return to_bool_not(bit_or(equal(a, zero), equal(b, zero)));
+		});
+	}
+
+	size_t logical_or(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) {
+			const auto zero = broadcast(0);
+			return to_bool_not(bit_and(equal(a, zero), equal(b, zero)));
+		});
+	}
+
+	size_t minimum(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return minimum(a, b); });
+	}
+
+	size_t maximum(int* left, const int* right, size_t count) {
+		return transform(left, right, count, [](Vector a, Vector b) { return maximum(a, b); });
+	}
+
+	// Ternary kernels
+	size_t clamp(int* values, const int* low, const int* high, size_t count) {
+		return transform(values, low, high, count, [](Vector v, Vector a, Vector b) { return minimum(maximum(v, a), b); });
+	}
+
+	// Checked kernels
+	size_t checked_negate(int* values, size_t count) {
+		return checked_transform(values, count, [](int value, int& result) { return InfixParser::Arithmetic::subtract_overflow(0, value, result); });
+	}
+
+	size_t checked_pre_increment(int* values, size_t count) {
+		return checked_transform(values, count, [](int value, int& result) { return InfixParser::Arithmetic::add_overflow(value, 1, result); });
+	}
+
+	size_t checked_pre_decrement(int* values, size_t count) {
+		return checked_transform(values, count, [](int value, int& result) { return InfixParser::Arithmetic::subtract_overflow(value, 1, result); });
+	}
+
+	size_t checked_power(int* left, const int* right, size_t count) {
+		return checked_transform(left, right, count, [](int a, int b, int& result) {
+			return InfixParser::Arithmetic::power_divides_by_zero(a, b) || InfixParser::Arithmetic::power_overflow(a, b, result);
+		});
+	}
+
+	size_t checked_multiply(int* left, const int* right, size_t count) {
+		return checked_transform(left, right, count, [](int a, int b, int& result) { return InfixParser::Arithmetic::multiply_overflow(a, b, result); });
+	}
+
+	size_t checked_divide(int* left, const int* right, size_t count) {
+		return checked_transform(left, right, count, [](int a, int b, int& result) {
+			return b == 0 || InfixParser::Arithmetic::divide_overflow(a, b, result);
+		});
+	}
+
+	size_t checked_add(int* left, const int* right, size_t count) {
+		return checked_transform(left, right, count, [](int a, int b, int& result) { return InfixParser::Arithmetic::add_overflow(a, b, result); });
+	}
+
+	size_t checked_subtract(int* left, const int* right, size_t count) {
+		return checked_transform(left, right, count, [](int a, int b, int& result) { return InfixParser::Arithmetic::subtract_overflow(a, b, result); });
+	}
+
+	size_t checked_absolute(int* values, size_t count) {
+		return checked_transform(values, count, [](int value, int& result) { return InfixParser::Arithmetic::absolute_overflow(value, result); });
+	}
+}
+
+namespace InfixParser::Kernels {
+	Kernel find(const Operator* op) {
+		Kernel kernel;
+
+		if (op == &Operator::NEGATE) {
+			kernel.unary = negate;
+		} else if (op == &Operator::NOT) {
+			kernel.unary = logical_not;
+		} else if (op == &Operator::PRE_INCREMENT) {
+			kernel.unary = pre_increment;
+		} else if (op == &Operator::PRE_DECREMENT) {
+			kernel.unary = pre_decrement;
+		} else if (op == &Operator::POWER) {
+			kernel.binary = power;
+		} else if (op == &Operator::MULTIPLY) {
+			kernel.binary = multiply;
+		} else if (op == &Operator::DIVIDE) {
+			kernel.binary = divide;
+		} else if (op == &Operator::REMAINDER) {
+			kernel.binary = remainder;
+		} else if (op == &Operator::ADD) {
+			kernel.binary = add;
+		} else if (op == &Operator::SUBTRACT) {
+			kernel.binary = subtract;
+		} else if (op == &Operator::GREATER) {
+			kernel.binary = greater;
+		} else if (op == &Operator::GREATER_OR_EQUAL) {
+			kernel.binary = greater_or_equal;
+		} else if (op == &Operator::LESS) {
+			kernel.binary = less;
+		} else if (op == &Operator::LESS_OR_EQUAL) {
+			kernel.binary = less_or_equal;
+		} else if (op == &Operator::EQUAL) {
+			kernel.binary = equal;
+		} else if (op == &Operator::NOT_EQUAL) {
+			kernel.binary = not_equal;
+		} else if (op == &Operator::AND) {
+			kernel.binary = logical_and;
+		} else if (op == &Operator::OR) {
+			kernel.binary = logical_or;
+		} else if (op == &Operator::ABS) {
+			kernel.unary = absolute;
+		} else if (op == &Operator::MIN) {
+			kernel.binary = minimum;
+		} else if (op == &Operator::MAX) {
+			kernel.binary = maximum;
+		} else if (op == &Operator::CLAMP) {
+			kernel.ternary = clamp;
+		} else if (op == &Operator::CHECKED_NEGATE) {
+			kernel.unary = checked_negate;
+		} else if (op == &Operator::CHECKED_PRE_INCREMENT) {
+			kernel.unary = checked_pre_increment;
+		} else if (op == &Operator::CHECKED_PRE_DECREMENT) {
+			kernel.unary = checked_pre_decrement;
+		} else if (op == &Operator::CHECKED_POWER) {
+			kernel.binary = checked_power;
+		} else if (op == &Operator::CHECKED_MULTIPLY) {
+			kernel.binary = checked_multiply;
+		} else if (op == &Operator::CHECKED_DIVIDE) {
+			kernel.binary = checked_divide;
+		} else if (op == &Operator::CHECKED_ADD) {
+			kernel.binary = checked_add;
+		} else if (op == &Operator::CHECKED_SUBTRACT) {
+			kernel.binary = checked_subtract;
+		} else if (op == &Operator::CHECKED_ABS) {
+			kernel.unary = checked_absolute;
+		}
+
+		return kernel;
+	}
+
+	const char* instruction_set() {
+	#if defined(INFIXPARSER_KERNELS_AVX2)
+		return "AVX2";
+	#elif defined(INFIXPARSER_KERNELS_SSE)
+		return "SSE";
+	#else
+		return "Scalar";
+	#endif
+	}
+}
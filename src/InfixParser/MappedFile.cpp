@@ -0,0 +1,96 @@
+// InfixParser
+#include <InfixParser/MappedFile.hpp>
+
+#if defined(INFIXPARSER_OS_WINDOWS)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace InfixParser {
+#if defined(INFIXPARSER_OS_WINDOWS)
+	MappedFile::MappedFile(const std::string& path) {
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE) {
+			file = nullptr;
+			throw MappedFileException{"Unable to open \"" + path + "\"."};
+		}
+
+		LARGE_INTEGER file_size;
+		GetFileSizeEx(file, &file_size);
+		length = static_cast<size_t>(file_size.QuadPart);
+
+		// Empty files cannot be mapped
+		if (length == 0) { return; }
+
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		first = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+		if (first == nullptr) {
+			if (mapping) { CloseHandle(mapping); }
+			CloseHandle(file);
+			throw MappedFileException{"Unable to map \"" + path + "\"."};
+		}
+	}
+
+	MappedFile::~MappedFile() {
+		if (first) { UnmapViewOfFile(first); }
+		if (mapping) { CloseHandle(mapping); }
+		if (file) { CloseHandle(file); }
+	}
+#else
+	MappedFile::MappedFile(const std::string& path) {
+		const auto file = open(path.c_str(), O_RDONLY);
+
+		if (file < 0) {
+			throw MappedFileException{"Unable to open \"" + path + "\"."};
+		}
+
+		struct stat info;
+
+		if (fstat(file, &info) != 0) {
+			close(file);
+			throw MappedFileException{"Unable to read the size of \"" + path + "\"."};
+		}
+
+		length = static_cast<size_t>(info.st_size);
+
+		// Empty files cannot be mapped
+		if (length != 0) {
+			auto memory = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+
+			if (memory == MAP_FAILED) {
+				close(file);
+				throw MappedFileException{"Unable to map \"" + path + "\"."};
+			}
+
+			// The file is read front to back
+			madvise(memory, length, MADV_SEQUENTIAL);
+			first = static_cast<const char*>(memory);
+		}
+
+		// The mapping keeps the file alive
+		close(file);
+	}
+
+	MappedFile::~MappedFile() {
+		if (first) {
+			munmap(const_cast<char*>(first), length);
+		}
+	}
+#endif
+
+	const char* MappedFile::data() const {
+		return first;
+	}
+
+	size_t MappedFile::size() const {
+		return length;
+	}
+}
@@ -1,216 +1,472 @@
+// InfixParser
 #include <InfixParser/Operator.hpp>
+#include <InfixParser/Arithmetic.hpp>
 
 namespace InfixParser {
-	Operator::Operator(std::string as_string, int precedence, bool right_associative, OperatorFunction function)
+	template<class T>
+	BasicOperator<T>::BasicOperator(std::string as_string, int precedence, bool right_associative, int arity, OperatorFunction function)
 		: as_string{std::move(as_string)}
 		, precedence_value{precedence}
 		, right_associative{right_associative}
+		, arity_value{arity}
+		, kind_value{OperatorKind::REGISTERED}
 		, function{function} {
 	};
 
-	std::string Operator::to_string() const {
+	template<class T>
+	BasicOperator<T>::BasicOperator(const OperatorInfo& info, OperatorFunction function)
+		: as_string{info.token}
+		, precedence_value{info.precedence}
+		, right_associative{info.right_associative}
+		, arity_value{info.arity}
+		, kind_value{info.kind}
+		, function{function} {
+	}
+
+	template<class T>
+	std::string BasicOperator<T>::to_string() const {
 		return as_string;
 	}
 
-	int Operator::precedence() const {
+	template<class T>
+	int BasicOperator<T>::precedence() const {
 		return precedence_value;
 	}
 
-	bool Operator::is_right_associative() const {
+	template<class T>
+	bool BasicOperator<T>::is_right_associative() const {
 		return right_associative;
 	}
 
-	void Operator::apply(OperandStack& operands) const {
-		function(operands);
+	template<class T>
+	int BasicOperator<T>::arity() const {
+		return arity_value;
+	}
+
+	template<class T>
+	OperatorKind BasicOperator<T>::kind() const {
+		return kind_value;
+	}
+
+	template<class T>
+	Error BasicOperator<T>::apply(BasicOperandStack<T>& operands) const {
+		return function(operands);
 	}
 }
 
 // Predefined operators
 namespace InfixParser {
-	const Operator Operator::NEGATE = {"N", 10, true, [](OperandStack& operands) {
-		if (operands.empty()) { throw OperatorException{"Operator N (NEGATE) requires at least one operand."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::NEGATE = {Grammar::NEGATE, [](BasicOperandStack<T>& operands) {
+		if (operands.empty()) { return Error::MISSING_OPERANDS; }
 
 		auto& right = operands.top();
-		right = -right;
+		right = Arithmetic::negate(right);
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::RIGHT_PAREN = {")", 9, false, [](OperandStack& operands) {
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::RIGHT_PAREN = {Grammar::RIGHT_PAREN, [](BasicOperandStack<T>&) {
+		return Error::NONE;
 	}};
 
-	const Operator Operator::NOT = {"!", 8, true, [](OperandStack& operands) {
-		if (operands.empty()) { throw OperatorException{"Operator ! (NOT) requires at least one operand."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::NOT = {Grammar::NOT, [](BasicOperandStack<T>& operands) {
+		if (operands.empty()) { return Error::MISSING_OPERANDS; }
 
 		auto& right = operands.top();
 		right = !right;
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::PRE_INCREMENT = {"++", 8, true, [](OperandStack& operands) {
-		if (operands.empty()) { throw OperatorException{"Operator ++ (PRE_INCREMENT) requires at least one operand."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::PRE_INCREMENT = {Grammar::PRE_INCREMENT, [](BasicOperandStack<T>& operands) {
+		if (operands.empty()) { return Error::MISSING_OPERANDS; }
 
 		auto& right = operands.top();
-		right = ++right;
+		right = Arithmetic::add(right, T{1});
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::PRE_DECREMENT = {"--", 8, true, [](OperandStack& operands) {
-		if (operands.empty()) { throw OperatorException{"Operator -- (PRE_DECREMENT) requires at least one operand."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::PRE_DECREMENT = {Grammar::PRE_DECREMENT, [](BasicOperandStack<T>& operands) {
+		if (operands.empty()) { return Error::MISSING_OPERANDS; }
 
 		auto& right = operands.top();
-		right = --right;
+		right = Arithmetic::subtract(right, T{1});
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::POWER = {"^", 7, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator ^ (POWER) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::POWER = {Grammar::POWER, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
-		auto res = round(pow(static_cast<double>(left), static_cast<double>(right)));
 
-		left = static_cast<decltype(right)>(res);
+		// A negative integer power of zero divides by zero
+		if (Arithmetic::power_divides_by_zero(left, right)) {
+			return Error::DIVISION_BY_ZERO;
+		}
+
+		left = Arithmetic::power(left, right);
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::MULTIPLY = {"*", 6, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator * (MULTIPLY) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::MULTIPLY = {Grammar::MULTIPLY, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
 
-		left = left * right;
+		left = Arithmetic::multiply(left, right);
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::DIVIDE = {"/", 6, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator / (DIVIDE) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::DIVIDE = {Grammar::DIVIDE, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		if (right == 0) {
-			throw OperatorException{"Division by zero."};
+			return Error::DIVISION_BY_ZERO;
 		}
 
 		auto& left = operands.top();
-		auto res = round(static_cast<double>(left) / static_cast<double>(right));
+		left = Arithmetic::divide(left, right);
 
-		left = static_cast<decltype(right)>(res);
+		return Error::NONE;
 	}};
 
-	const Operator Operator::REMAINDER = {"%", 6, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator % (REMAINDER) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::REMAINDER = {Grammar::REMAINDER, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		if (right == 0) {
-			throw OperatorException{"Remainder cannot be found when dividing by zero."};
+			return Error::REMAINDER_BY_ZERO;
 		}
 		
 		auto& left = operands.top();
-		left = left % right;
+		left = Arithmetic::remainder(left, right);
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::ADD = {"+", 5, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator + (ADD) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::ADD = {Grammar::ADD, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
-		left = left + right;
+		left = Arithmetic::add(left, right);
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::SUBTRACT = {"-", 5, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator - (SUBTRACT) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::SUBTRACT = {Grammar::SUBTRACT, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
-		left = left - right;
+		left = Arithmetic::subtract(left, right);
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::GREATER = {">", 4, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator > (GREATER) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::GREATER = {Grammar::GREATER, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
 		left = left > right;
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::GREATER_OR_EQUAL = {">=", 4, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator >= (GREATER_OR_EQUAL) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::GREATER_OR_EQUAL = {Grammar::GREATER_OR_EQUAL, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
 		left = left >= right;
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::LESS = {"<", 4, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator < (LESS) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::LESS = {Grammar::LESS, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
 		left = left < right;
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::LESS_OR_EQUAL = {"<=", 4, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator <= (LESS_OR_EQUAL) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::LESS_OR_EQUAL = {Grammar::LESS_OR_EQUAL, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
 		left = left <= right;
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::EQUAL = {"==", 3, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator == (EQUAL) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::EQUAL = {Grammar::EQUAL, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
 		left = left == right;
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::NOT_EQUAL = {"!=", 3, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator != (NOT_EQUAL) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::NOT_EQUAL = {Grammar::NOT_EQUAL, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
 		left = left != right;
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::AND = {"&&", 2, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator && (AND) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::AND = {Grammar::AND, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
 		left = left && right;
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::OR = {"||", 1, false, [](OperandStack& operands) {
-		if (operands.size() < 2) { throw OperatorException{"Operator || (OR) requires at least two operands."}; }
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::OR = {Grammar::OR, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
 
 		auto right = operands.top();
 		operands.pop();
 
 		auto& left = operands.top();
 		left = left || right;
+
+		return Error::NONE;
 	}};
 
-	const Operator Operator::LEFT_PAREN = {"(", 0, true, [](OperandStack& operands) {
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::LEFT_PAREN = {Grammar::LEFT_PAREN, [](BasicOperandStack<T>&) {
+		return Error::NONE;
 	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::COMMA = {Grammar::COMMA, [](BasicOperandStack<T>&) {
+		return Error::NONE;
+	}};
+}
+
+// Built-in functions
+namespace InfixParser {
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::ABS = {Grammar::ABS, [](BasicOperandStack<T>& operands) {
+		if (operands.empty()) { return Error::MISSING_OPERANDS; }
+
+		auto& value = operands.top();
+		value = Arithmetic::absolute(value);
+
+		return Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::MIN = {Grammar::MIN, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		auto right = operands.top();
+		operands.pop();
+
+		auto& left = operands.top();
+		left = Arithmetic::minimum(left, right);
+
+		return Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::MAX = {Grammar::MAX, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		auto right = operands.top();
+		operands.pop();
+
+		auto& left = operands.top();
+		left = Arithmetic::maximum(left, right);
+
+		return Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::CLAMP = {Grammar::CLAMP, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 3) { return Error::MISSING_OPERANDS; }
+
+		auto high = operands.top();
+		operands.pop();
+
+		auto low = operands.top();
+		operands.pop();
+
+		auto& value = operands.top();
+		value = Arithmetic::clamp(value, low, high);
+
+		return Error::NONE;
+	}};
+}
+
+// Predefined checked operators. Doubles never overflow, so for them these are the same as the unchecked operators.
+namespace InfixParser {
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::CHECKED_NEGATE = {Grammar::NEGATE, [](BasicOperandStack<T>& operands) {
+		if (operands.empty()) { return Error::MISSING_OPERANDS; }
+
+		auto& right = operands.top();
+		return Arithmetic::subtract_overflow(T{0}, right, right) ? Error::INTEGER_OVERFLOW : Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::CHECKED_PRE_INCREMENT = {Grammar::PRE_INCREMENT, [](BasicOperandStack<T>& operands) {
+		if (operands.empty()) { return Error::MISSING_OPERANDS; }
+
+		auto& right = operands.top();
+		return Arithmetic::add_overflow(right, T{1}, right) ? Error::INTEGER_OVERFLOW : Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::CHECKED_PRE_DECREMENT = {Grammar::PRE_DECREMENT, [](BasicOperandStack<T>& operands) {
+		if (operands.empty()) { return Error::MISSING_OPERANDS; }
+
+		auto& right = operands.top();
+		return Arithmetic::subtract_overflow(right, T{1}, right) ? Error::INTEGER_OVERFLOW : Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::CHECKED_POWER = {Grammar::POWER, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		auto right = operands.top();
+		operands.pop();
+
+		auto& left = operands.top();
+
+		// A negative integer power of zero divides by zero
+		if (Arithmetic::power_divides_by_zero(left, right)) {
+			return Error::DIVISION_BY_ZERO;
+		}
+
+		return Arithmetic::power_overflow(left, right, left) ? Error::INTEGER_OVERFLOW : Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::CHECKED_MULTIPLY = {Grammar::MULTIPLY, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		auto right = operands.top();
+		operands.pop();
+
+		auto& left = operands.top();
+		return Arithmetic::multiply_overflow(left, right, left) ? Error::INTEGER_OVERFLOW : Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::CHECKED_DIVIDE = {Grammar::DIVIDE, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		auto right = operands.top();
+		operands.pop();
+
+		if (right == 0) {
+			return Error::DIVISION_BY_ZERO;
+		}
+
+		auto& left = operands.top();
+		return Arithmetic::divide_overflow(left, right, left) ? Error::INTEGER_OVERFLOW : Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::CHECKED_ADD = {Grammar::ADD, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		auto right = operands.top();
+		operands.pop();
+
+		auto& left = operands.top();
+		return Arithmetic::add_overflow(left, right, left) ? Error::INTEGER_OVERFLOW : Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::CHECKED_SUBTRACT = {Grammar::SUBTRACT, [](BasicOperandStack<T>& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		auto right = operands.top();
+		operands.pop();
+
+		auto& left = operands.top();
+		return Arithmetic::subtract_overflow(left, right, left) ? Error::INTEGER_OVERFLOW : Error::NONE;
+	}};
+
+	template<class T>
+	const BasicOperator<T> BasicOperator<T>::CHECKED_ABS = {Grammar::ABS, [](BasicOperandStack<T>& operands) {
+		if (operands.empty()) { return Error::MISSING_OPERANDS; }
+
+		auto& value = operands.top();
+		return Arithmetic::absolute_overflow(value, value) ? Error::INTEGER_OVERFLOW : Error::NONE;
+	}};
+
+	template class BasicOperator<int>;
+	template class BasicOperator<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	template class BasicOperator<__int128>;
+#endif
+	template class BasicOperator<double>;
 }
\ No newline at end of file
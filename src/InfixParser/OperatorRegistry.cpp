@@ -0,0 +1,186 @@
+// STD
+#include <algorithm>
+#include <memory>
+
+// InfixParser
+#include <InfixParser/OperatorRegistry.hpp>
+#include <InfixParser/InfixParser.hpp>
+
+namespace {
+	// Checks if c can be part of an operator symbol without being read as a number, variable or whitespace
+	bool is_symbol(char c) {
+		using namespace InfixParser;
+		return !Lexer::has_class(c, Lexer::WHITESPACE | Lexer::DIGIT | Lexer::LETTER) && c != '\0';
+	}
+}
+
+namespace InfixParser {
+	template<class T>
+	BasicOperatorRegistry<T>::BasicOperatorRegistry() {
+		using Operator = BasicOperator<T>;
+
+		add("-", Operator::NEGATE);
+		add(")", Operator::RIGHT_PAREN);
+		add("!", Operator::NOT);
+		add("++", Operator::PRE_INCREMENT);
+		add("--", Operator::PRE_DECREMENT);
+		add("^", Operator::POWER);
+		add("*", Operator::MULTIPLY);
+		add("/", Operator::DIVIDE);
+		add("%", Operator::REMAINDER);
+		add("+", Operator::ADD);
+		add("-", Operator::SUBTRACT);
+		add(">", Operator::GREATER);
+		add(">=", Operator::GREATER_OR_EQUAL);
+		add("<", Operator::LESS);
+		add("<=", Operator::LESS_OR_EQUAL);
+		add("==", Operator::EQUAL);
+		add("!=", Operator::NOT_EQUAL);
+		add("&&", Operator::AND);
+		add("||", Operator::OR);
+		add("(", Operator::LEFT_PAREN);
+		add(",", Operator::COMMA);
+	}
+
+	template<class T>
+	const BasicOperator<T>& BasicOperatorRegistry<T>::add(std::string symbol, int precedence, bool right_associative, int arity, typename BasicOperator<T>::OperatorFunction function) {
+		if (frozen) {
+			throw OperatorRegistryException{"Operators cannot be registered once the registry is frozen."};
+		}
+
+		// Precedence 0 is reserved for ( and , which must never be applied by a registered operator
+		if (precedence < 1) {
+			throw OperatorRegistryException{"Operator \"" + symbol + "\" must have a precedence of at least 1."};
+		}
+
+		// Instructions, kernels and expression set nodes have room for at most three operands
+		if (arity < 1 || arity > 3) {
+			throw OperatorRegistryException{"Operator \"" + symbol + "\" must take one, two or three operands."};
+		}
+
+		const auto& op = owned.emplace_back(symbol, precedence, right_associative, arity, function);
+
+		try {
+			add(symbol, op);
+		} catch (...) {
+			owned.pop_back();
+			throw;
+		}
+
+		return op;
+	}
+
+	template<class T>
+	void BasicOperatorRegistry<T>::add(std::string_view symbol, const BasicOperator<T>& op) {
+		if (frozen) {
+			throw OperatorRegistryException{"Operators cannot be registered once the registry is frozen."};
+		}
+
+		if (symbol.empty() || !std::all_of(symbol.begin(), symbol.end(), is_symbol)) {
+			throw OperatorRegistryException{"Invalid operator symbol \"" + std::string{symbol} + "\"."};
+		}
+
+		auto found = std::find_if(entries.begin(), entries.end(), [&](const Entry& entry) { return entry.symbol == symbol; });
+
+		if (found == entries.end()) {
+			found = entries.insert(entries.end(), Entry{std::string{symbol}});
+		}
+
+		// Unary right associative operators apply to the operand that follows them
+		auto& slot = op.arity() == 1 && op.is_right_associative() ? found->prefix : found->infix;
+
+		if (slot != nullptr) {
+			throw OperatorRegistryException{"Operator \"" + std::string{symbol} + "\" is already registered."};
+		}
+
+		slot = &op;
+	}
+
+	template<class T>
+	void BasicOperatorRegistry<T>::freeze() {
+		if (frozen) { return; }
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& left, const Entry& right) {
+			return left.symbol < right.symbol;
+		});
+
+		// The first level of the trie is copied into the root table
+		const auto [first, count] = build(0, entries.size(), 0);
+
+		for (auto child = first; child != first + count; ++child) {
+			auto& root = roots[static_cast<unsigned char>(nodes[child].label)];
+			root.node = nodes[child];
+
+			if (root.node.child_count == 1 && nodes[root.node.first_child].child_count == 0) {
+				root.leaf = nodes[root.node.first_child];
+				root.node.child_count = 0;
+			}
+		}
+
+		frozen = true;
+	}
+
+	template<class T>
+	bool BasicOperatorRegistry<T>::is_frozen() const {
+		return frozen;
+	}
+
+	template<class T>
+	std::pair<uint32_t, uint32_t> BasicOperatorRegistry<T>::build(size_t begin, size_t end, size_t depth) {
+		// The entry of the node itself sorts first
+		if (begin != end && entries[begin].symbol.size() == depth) {
+			++begin;
+		}
+
+		// Find where each child's entries end
+		std::vector<size_t> ends;
+
+		for (auto i = begin; i != end; ++i) {
+			if (i + 1 == end || entries[i + 1].symbol[depth] != entries[i].symbol[depth]) {
+				ends.push_back(i + 1);
+			}
+		}
+
+		// Add the children next to each other before any of their descendants
+		const auto first = static_cast<uint32_t>(nodes.size());
+
+		for (size_t i = 0; i < ends.size(); ++i) {
+			const auto& entry = entries[i == 0 ? begin : ends[i - 1]];
+			Node node;
+			node.label = entry.symbol[depth];
+
+			if (entry.symbol.size() == depth + 1) {
+				node.operators[0] = entry.infix != nullptr ? entry.infix : entry.prefix;
+				node.operators[1] = entry.prefix != nullptr ? entry.prefix : entry.infix;
+			}
+
+			nodes.push_back(node);
+		}
+
+		for (size_t i = 0; i < ends.size(); ++i) {
+			const auto [child_first, child_count] = build(i == 0 ? begin : ends[i - 1], ends[i], depth + 1);
+			nodes[first + i].first_child = child_first;
+			nodes[first + i].child_count = static_cast<uint16_t>(child_count);
+		}
+
+		return {first, static_cast<uint32_t>(ends.size())};
+	}
+
+	template<class T>
+	const BasicOperatorRegistry<T>& BasicOperatorRegistry<T>::predefined() {
+		static const auto registry = []{
+			auto registry = std::make_unique<BasicOperatorRegistry>();
+			registry->freeze();
+			return registry;
+		}();
+
+		return *registry;
+	}
+
+	template class BasicOperatorRegistry<int>;
+	template class BasicOperatorRegistry<int64_t>;
+#if defined(INFIXPARSER_INT128)
+	template class BasicOperatorRegistry<__int128>;
+#endif
+	template class BasicOperatorRegistry<double>;
+}
@@ -0,0 +1,190 @@
+// STD
+#include <algorithm>
+
+// InfixParser
+#include <InfixParser/ThreadPool.hpp>
+
+namespace {
+	uint64_t pack(uint32_t begin, uint32_t end) {
+		return (static_cast<uint64_t>(begin) << 32) | end;
+	}
+
+	uint32_t unpack_begin(uint64_t chunks) {
+		return static_cast<uint32_t>(chunks >> 32);
+	}
+
+	uint32_t unpack_end(uint64_t chunks) {
+		return static_cast<uint32_t>(chunks);
+	}
+}
+
+namespace InfixParser {
+	ThreadPool::ThreadPool(size_t workers) {
+		workers = std::max<size_t>(1, workers);
+		shares = std::make_unique<Share[]>(workers);
+
+		for (size_t i = 0; i + 1 < workers; ++i) {
+			threads.emplace_back([this, i]{ loop(i); });
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			stopping = true;
+		}
+
+		wake.notify_all();
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	size_t ThreadPool::size() const {
+		return threads.size() + 1;
+	}
+
+	void ThreadPool::run(size_t count, size_t grain, const Task& task) {
+		if (count == 0) { return; }
+
+		std::lock_guard<std::mutex> run_lock{run_mutex};
+
+		// Make the chunks large enough that their indices fit in 32 bits
+		grain = std::max<size_t>({1, grain, count / UINT32_MAX + 1});
+		const auto chunks = (count + grain - 1) / grain;
+		const auto workers = size();
+
+		// Give each worker an equal share of the chunks
+		for (size_t i = 0; i < workers; ++i) {
+			const auto begin = chunks * i / workers;
+			const auto end = chunks * (i + 1) / workers;
+			shares[i].chunks.store(pack(static_cast<uint32_t>(begin), static_cast<uint32_t>(end)), std::memory_order_relaxed);
+		}
+
+		// Start the background threads
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			this->task = &task;
+			item_count = count;
+			item_grain = grain;
+			error = nullptr;
+			active = threads.size();
+			++generation;
+		}
+
+		wake.notify_all();
+
+		// Work on the calling thread too, then wait for the others
+		work(workers - 1);
+
+		std::unique_lock<std::mutex> lock{mutex};
+		done.wait(lock, [this]{ return active == 0; });
+		this->task = nullptr;
+
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	ThreadPool& ThreadPool::global() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+	void ThreadPool::loop(size_t worker) {
+		uint64_t seen = 0;
+
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock{mutex};
+				wake.wait(lock, [&]{ return stopping || generation != seen; });
+
+				if (stopping) { return; }
+				seen = generation;
+			}
+
+			work(worker);
+
+			{
+				std::lock_guard<std::mutex> lock{mutex};
+
+				if (--active == 0) {
+					done.notify_all();
+				}
+			}
+		}
+	}
+
+	void ThreadPool::work(size_t worker) {
+		const auto workers = size();
+		auto& own = shares[worker];
+
+		while (true) {
+			// Run our own chunks from the front
+			uint32_t chunk;
+
+			while (take(own, chunk)) {
+				const auto begin = chunk * item_grain;
+				const auto end = std::min(item_count, begin + item_grain);
+
+				try {
+					(*task)(worker, begin, end);
+				} catch (...) {
+					std::lock_guard<std::mutex> lock{mutex};
+					if (!error) { error = std::current_exception(); }
+				}
+			}
+
+			// Steal from the back of another worker's share
+			bool stolen = false;
+
+			for (size_t i = 1; i < workers && !stolen; ++i) {
+				uint32_t begin, end;
+
+				if (steal(shares[(worker + i) % workers], begin, end)) {
+					own.chunks.store(pack(begin, end), std::memory_order_release);
+					stolen = true;
+				}
+			}
+
+			if (!stolen) { return; }
+		}
+	}
+
+	bool ThreadPool::take(Share& share, uint32_t& chunk) {
+		auto chunks = share.chunks.load(std::memory_order_acquire);
+
+		while (true) {
+			const auto begin = unpack_begin(chunks);
+			const auto end = unpack_end(chunks);
+
+			if (begin >= end) { return false; }
+
+			if (share.chunks.compare_exchange_weak(chunks, pack(begin + 1, end), std::memory_order_acq_rel)) {
+				chunk = begin;
+				return true;
+			}
+		}
+	}
+
+	bool ThreadPool::steal(Share& share, uint32_t& begin, uint32_t& end) {
+		auto chunks = share.chunks.load(std::memory_order_acquire);
+
+		while (true) {
+			const auto first = unpack_begin(chunks);
+			const auto last = unpack_end(chunks);
+
+			if (first >= last) { return false; }
+
+			// Leave the owner the front half, rounding up so a single chunk is stolen whole
+			const auto middle = first + (last - first) / 2;
+
+			if (share.chunks.compare_exchange_weak(chunks, pack(first, middle), std::memory_order_acq_rel)) {
+				begin = middle;
+				end = last;
+				return true;
+			}
+		}
+	}
+}
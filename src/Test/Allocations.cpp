@@ -0,0 +1,36 @@
+// STD
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Test
+#include <Test/Test.hpp>
+
+namespace {
+	/** The number of times operator new has been called */
+	std::atomic<size_t> allocations{0};
+}
+
+// Count every allocation made by the program.
+// These are kept in their own file so that they are never inlined into the code being measured.
+void* operator new(std::size_t size) {
+	++allocations;
+
+	if (auto memory = std::malloc(size ? size : 1)) {
+		return memory;
+	}
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+size_t Test::allocation_count() {
+	return allocations.load();
+}
@@ -1,4 +1,5 @@
 // STD
+#include <algorithm>
 #include <iostream>
 
 // Test
@@ -6,20 +7,46 @@
 
 // InfixParser
 #include <InfixParser/Evaluator.hpp>
+#include <InfixParser/ConstantEvaluator.hpp>
+#include <InfixParser/ExpressionSet.hpp>
+
+namespace {
+	/**
+	 * @brief Generates @p count columns of @p rows values between -20 and 20.
+	 * @param[in] count The number of columns.
+	 * @param[in] rows The number of values in each column.
+	 * @param[out] columns The generated columns.
+	 * @param[out] column_pointers A pointer to the data of each column.
+	 */
+	void generate_columns(size_t count, size_t rows, std::vector<std::vector<int>>& columns, std::vector<const int*>& column_pointers) {
+		columns.assign(count, std::vector<int>(rows));
+		column_pointers.clear();
+
+		for (size_t i = 0; i < count; ++i) {
+			for (size_t row = 0; row < rows; ++row) {
+				columns[i][row] = static_cast<int>((row * 7 + i * 13 + row / 41) % 41) - 20;
+			}
+
+			column_pointers.push_back(columns[i].data());
+		}
+	}
+}
 
 void Test::check_equation(const std::string& equation, int expected) {
-	static InfixParser::Evaluator evaluator;
+	thread_local InfixParser::Evaluator evaluator;
 	auto value = evaluator.evaluate(equation);
 
 	// Print a warning if equation does not evaluate to expected
 	if (value != expected) {
 		std::cout << "Incorrect equation: " << equation << " is " << value << " which does not equal " << expected << std::endl;
 	}
+
+	check_eval(equation);
 }
 
 
 void Test::check_equation_throws(const std::string& equation, bool print) {
-	static InfixParser::Evaluator evaluator;
+	thread_local InfixParser::Evaluator evaluator;
 	bool thrown = false;
 	int value = 0;
 
@@ -38,4 +65,232 @@ void Test::check_equation_throws(const std::string& equation, bool print) {
 	if (!thrown) {
 		std::cout << "No exception thrown for equation: " << equation << " value given " << value << "\n" << std::endl;
 	}
+
+	check_eval(equation);
+}
+
+void Test::check_error(const std::string& equation, InfixParser::Error error, size_t position, bool print) {
+	thread_local InfixParser::Evaluator evaluator;
+	const auto result = evaluator.try_evaluate(equation);
+
+	if (result.error != error || result.position != position) {
+		std::cout << "Incorrect error for equation: " << equation << " is " << InfixParser::to_string(result.error) << " @ " << result.position
+			<< " not " << InfixParser::to_string(error) << " @ " << position << std::endl;
+	}
+
+	// The message must not depend on which API reported the error
+	std::string thrown;
+
+	try {
+		evaluator.evaluate(equation);
+	} catch (const InfixParser::EvaluationException& except) {
+		thrown = except.what();
+	}
+
+	if (result.message(equation) != thrown) {
+		std::cout << "Incorrect error message for equation: " << equation << "\n" << result.message(equation) << "\nnot\n" << thrown << std::endl;
+	}
+
+	if (print) {
+		std::cout << result.message(equation) << std::endl;
+	}
+
+	check_eval(equation);
+}
+
+void Test::check_eval(const std::string& equation) {
+	// eval() holds the program and its stacks in arrays, so the capacity must be larger than the equation
+	constexpr size_t capacity = 512;
+
+	if (equation.size() >= capacity) {
+		return;
+	}
+
+	thread_local InfixParser::Evaluator evaluator;
+	const auto expected = evaluator.try_evaluate(equation);
+	const auto actual = InfixParser::ConstantEvaluator<int, capacity>{}.try_evaluate(equation);
+
+	// Print a warning if eval() reads or evaluates the equation differently
+	if (actual.error != expected.error || actual.position != expected.position || actual.value != expected.value) {
+		std::cout << "Incorrect eval result for equation: " << equation << " is " << actual.value << " " << InfixParser::to_string(actual.error)
+			<< " @ " << actual.position << " not " << expected.value << " " << InfixParser::to_string(expected.error) << " @ " << expected.position << std::endl;
+	}
+}
+
+void Test::check_compiled(const std::string& equation, int expected) {
+	check_compiled(equation, {}, expected);
+}
+
+void Test::check_compiled(const std::string& equation, const std::vector<int>& values, int expected) {
+	thread_local InfixParser::Evaluator evaluator;
+	const auto expression = evaluator.compile(equation);
+
+	if (expression.variables().size() != values.size()) {
+		std::cout << "Incorrect variable count: " << equation << " has " << expression.variables().size() << " variables not " << values.size() << std::endl;
+		return;
+	}
+
+	// Print a warning if any run does not evaluate to expected
+	for (int i = 0; i < 2; ++i) {
+		auto value = expression.run(values.data());
+
+		if (value != expected) {
+			std::cout << "Incorrect compiled equation: " << equation << " is " << value << " which does not equal " << expected << std::endl;
+		}
+	}
+}
+
+void Test::check_optimized(const std::string& equation, const std::vector<int>& values, size_t instructions, int expected) {
+	thread_local InfixParser::Evaluator evaluator;
+	const auto expression = evaluator.compile(equation);
+
+	if (expression.instructions().size() != instructions) {
+		std::cout << "Incorrect optimization: " << equation << " has " << expression.instructions().size() << " instructions not " << instructions << std::endl;
+	}
+
+	check_compiled(equation, values, expected);
+}
+
+void Test::check_batch(const std::string& equation, size_t rows) {
+	thread_local InfixParser::Evaluator evaluator;
+	const auto expression = evaluator.compile(equation);
+	const auto variables = expression.variables().size();
+
+	// Generate the columns
+	std::vector<std::vector<int>> columns;
+	std::vector<const int*> column_pointers;
+	generate_columns(variables, rows, columns, column_pointers);
+
+	// Evaluate every row at once
+	std::vector<int> results(rows);
+	expression.run_batch(column_pointers.data(), results.data(), rows);
+
+	// Print a warning if any row differs from evaluating it alone
+	std::vector<int> values(variables);
+
+	for (size_t row = 0; row < rows; ++row) {
+		for (size_t i = 0; i < variables; ++i) {
+			values[i] = columns[i][row];
+		}
+
+		auto expected = expression.run(values.data());
+
+		if (results[row] != expected) {
+			std::cout << "Incorrect batch result: " << equation << " row " << row << " is " << results[row] << " which does not equal " << expected << std::endl;
+			return;
+		}
+	}
+}
+
+void Test::check_filter(const std::string& equation, size_t rows) {
+	thread_local InfixParser::Evaluator evaluator;
+	const auto expression = evaluator.compile(equation);
+
+	// Generate the columns
+	std::vector<std::vector<int>> columns;
+	std::vector<const int*> column_pointers;
+	generate_columns(expression.variables().size(), rows, columns, column_pointers);
+
+	// Find the expected rows
+	std::vector<int> results(rows);
+	expression.run_batch(column_pointers.data(), results.data(), rows);
+
+	std::vector<size_t> expected;
+
+	for (size_t row = 0; row < rows; ++row) {
+		if (results[row] != 0) { expected.push_back(row); }
+	}
+
+	// Print a warning if the selection or bitmap differ from the expected rows
+	std::vector<size_t> selection;
+	expression.filter(column_pointers.data(), rows, selection);
+
+	if (selection != expected) {
+		std::cout << "Incorrect filter selection: " << equation << " selected " << selection.size() << " rows instead of " << expected.size() << std::endl;
+	}
+
+	std::vector<uint64_t> bitmap;
+	expression.filter_bitmap(column_pointers.data(), rows, bitmap);
+
+	for (size_t row = 0; row < rows; ++row) {
+		const bool selected = (bitmap[row / 64] >> (row % 64)) & 1;
+
+		if (selected != (results[row] != 0)) {
+			std::cout << "Incorrect filter bitmap: " << equation << " row " << row << std::endl;
+			return;
+		}
+	}
+}
+
+void Test::check_expression_set(const std::vector<std::string>& equations, size_t rows) {
+	thread_local InfixParser::Evaluator evaluator;
+	std::vector<InfixParser::CompiledExpression> expressions;
+
+	for (const auto& equation : equations) {
+		expressions.push_back(evaluator.compile(equation));
+	}
+
+	const InfixParser::ExpressionSet set{expressions};
+	const auto variables = set.variables().size();
+
+	// Generate the columns
+	std::vector<std::vector<int>> columns;
+	std::vector<const int*> column_pointers;
+	generate_columns(variables, rows, columns, column_pointers);
+
+	// Evaluate every expression for every row at once
+	std::vector<std::vector<int>> results(equations.size(), std::vector<int>(rows));
+	std::vector<int*> result_pointers;
+
+	for (auto& result : results) {
+		result_pointers.push_back(result.data());
+	}
+
+	set.run_batch(column_pointers.data(), result_pointers.data(), rows);
+
+	// Print a warning if any result differs from running its expression alone
+	std::vector<int> values(variables);
+	std::vector<int> row_results(equations.size());
+	std::vector<int> expression_values;
+
+	for (size_t row = 0; row < rows; ++row) {
+		for (size_t i = 0; i < variables; ++i) {
+			values[i] = columns[i][row];
+		}
+
+		set.run(values.data(), row_results.data());
+
+		for (size_t i = 0; i < equations.size(); ++i) {
+			// Each expression has its own slots
+			expression_values.clear();
+
+			for (const auto& name : expressions[i].variables()) {
+				const auto slot = std::find(set.variables().cbegin(), set.variables().cend(), name) - set.variables().cbegin();
+				expression_values.push_back(values[static_cast<size_t>(slot)]);
+			}
+
+			const auto expected = expressions[i].run(expression_values.data());
+
+			if (results[i][row] != expected || row_results[i] != expected) {
+				std::cout << "Incorrect expression set result: " << equations[i] << " row " << row << " is " << results[i][row] << " which does not equal " << expected << std::endl;
+				return;
+			}
+		}
+	}
+}
+
+void Test::check_no_allocations(std::string_view equation) {
+	thread_local InfixParser::Evaluator evaluator;
+
+	// Let the evaluator grow its buffers
+	auto expected = evaluator.evaluate(equation);
+
+	// Print a warning if evaluating again allocates or gives a different result
+	const auto before = allocation_count();
+	auto value = evaluator.evaluate(equation);
+	const auto count = allocation_count() - before;
+
+	if (count != 0 || value != expected) {
+		std::cout << "Evaluating " << equation << " made " << count << " allocations" << std::endl;
+	}
 }
\ No newline at end of file
@@ -1,10 +1,32 @@
 // STD
 #include <iostream>
 #include <stack>
+#include <thread>
+#include <chrono>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <algorithm>
 
 // InfixParser
 #include <InfixParser/InfixParser.hpp>
 #include <InfixParser/Evaluator.hpp>
+#include <InfixParser/ExpressionCache.hpp>
+#include <InfixParser/EvaluateBatch.hpp>
+#include <InfixParser/MappedFile.hpp>
+#include <InfixParser/Arithmetic.hpp>
+#include <InfixParser/ConstantEvaluator.hpp>
+#include <InfixParser/OperatorRegistry.hpp>
+#include <InfixParser/FormulaGraph.hpp>
+#include <InfixParser/ExpressionSet.hpp>
+#include <InfixParser/ExpressionPack.hpp>
 
 // Test
 #include <Test/Test.hpp>
@@ -252,6 +274,8 @@ void equation_tests_mixed() {
 	Test::check_equation("6/3 + (4==--5)", 3);
 	Test::check_equation("1 == 0 || 1 != 0", true);
 	Test::check_equation("(3==-2&&1!=0) || -39==-39", true);
+	Test::check_equation("(1) - 2 -(-3)", 2);
+	Test::check_equation("(2 * 3) -1 - (4)-(5)", -4);
 }
 
 void equation_throws_tests(bool print) {
@@ -285,31 +309,1571 @@ void equation_throws_tests(bool print) {
 	Test::check_equation_throws("", print);
 }
 
+void try_evaluate_tests(bool print) {
+	using InfixParser::Error;
+
+	// Errors are reported as a code and a position, with the same message evaluate() throws
+	Test::check_error("", Error::EMPTY_EQUATION, 0, print);
+	Test::check_error(")3+2", Error::EXPECTED_OPERAND, 0, print);
+	Test::check_error("15+3 2", Error::EXPECTED_OPERATOR, 4, print);
+	Test::check_error("1 + 99999999999999999999", Error::NUMBER_TOO_LARGE, 23, print);
+	Test::check_error("2 ? 3", Error::UNKNOWN_OPERATOR, 2, print);
+	Test::check_error("2 + x", Error::UNKNOWN_VARIABLE, 4, print);
+	Test::check_error("(", Error::EXPECTED_FINAL_OPERAND, 0, print);
+	Test::check_error("3 -", Error::MISSING_OPERANDS, 2, print);
+	Test::check_error("1 + * 3", Error::MISSING_OPERANDS, 6, print);
+	Test::check_error("1 + 2)", Error::EXTRANEOUS_PARENTHESIS, 5, print);
+	Test::check_error("1/0", Error::DIVISION_BY_ZERO, 2, print);
+	Test::check_error("3 % 0", Error::REMAINDER_BY_ZERO, 4, print);
+
+	// Valid equations are evaluated as usual
+	InfixParser::Evaluator evaluator;
+
+	for (const auto& [equation, expected] : {std::pair{"(1+2)*3", 9}, std::pair{"0 && 1/0", 0}, std::pair{"-2 + (3%5)^3*-1 + ++3", -25}}) {
+		const auto result = evaluator.try_evaluate(equation);
+
+		if (!result.ok() || result.value != expected || !result.message(equation).empty()) {
+			std::cout << "Incorrect try_evaluate result for equation: " << equation << " is " << result.value << " not " << expected << std::endl;
+		}
+	}
+
+	// Operand counts are spelled out in the descriptions of operators and functions
+	for (const auto& [equation, expected] : {std::pair{"3 -", "Operator - (SUBTRACT) requires at least two operands."}, std::pair{"abs(1, 2)", "Function abs (ABS) takes one argument."}, std::pair{"clamp(1, 2, 3, 4)", "Function clamp (CLAMP) takes three arguments."}}) {
+		const auto description = evaluator.try_evaluate(equation).description(equation);
+
+		if (description != expected) {
+			std::cout << "Incorrect description for equation: " << equation << " is \"" << description << "\" not \"" << expected << '"' << std::endl;
+		}
+	}
+
+	// Reporting an error does not allocate once the evaluator has warmed up
+	for (const char* equation : {"1 + 2 * 3) + 4", "1 + 2 * 3 # 4", "2 + x", "1 + (2 / 0)"}) {
+		evaluator.try_evaluate(equation);
+
+		const auto before = Test::allocation_count();
+		const auto result = evaluator.try_evaluate(equation);
+
+		if (result.ok() || Test::allocation_count() != before) {
+			std::cout << "Reporting an error allocated memory for equation: " << equation << std::endl;
+		}
+	}
+}
+
+void compiled_tests(bool print) {
+	Test::check_compiled("1+2*3", 7);
+	Test::check_compiled("(1+2)*3", 9);
+	Test::check_compiled("++++2-5*(3^2)", -41);
+	Test::check_compiled("-2 + (3%5)^3*-1 + ++3", -25);
+	Test::check_compiled("(3==-2&&1!=0) || -39==-39", true);
+	Test::check_compiled("(a) - b", {7, 2}, 5);
+
+	// Compiling reports the same errors as evaluating
+	InfixParser::Evaluator evaluator;
+
+	try {
+		evaluator.compile("3&&&&5");
+		std::cout << "No exception thrown when compiling: 3&&&&5\n" << std::endl;
+	} catch (const InfixParser::EvaluationException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+
+	// Runtime errors are reported when the expression is run
+	const auto expression = evaluator.compile("4 / (2 - 2)");
+
+	try {
+		expression.run();
+		std::cout << "No exception thrown when running: 4 / (2 - 2)\n" << std::endl;
+	} catch (const InfixParser::EvaluationException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+}
+
+void variable_tests(bool print) {
+	Test::check_compiled("x", {5}, 5);
+	Test::check_compiled("2 + x", {3}, 5);
+	Test::check_compiled("-x * x", {4}, -16);
+	Test::check_compiled("a - b + a", {10, 4}, 16);
+	Test::check_compiled("(price * qty > limit) && !_flag2", {25, 4, 90, 0}, true);
+	Test::check_compiled("++count_1 ^ 2", {2}, 9);
+	Test::check_compiled("(a ^ b / c % d - -a) + b * c - !d + (a > b || c && d) + --a * ++b", {7, 2, 3, 5}, 33);
+	Test::check_compiled("(a >= b) + (a <= b) * 2 + (a == b) * 4 + (a != b) * 8 + (a < b) * 16", {3, 4}, 26);
+
+	// Variables are not operands when adjacent
+	Test::check_equation_throws("x y", print);
+
+	// A shared layout assigns slots by name
+	InfixParser::Evaluator evaluator;
+	const std::vector<std::string> layout = {"a", "b", "c"};
+	const int values[] = {1, 2, 3};
+	const auto expression = evaluator.compile("c * 10 + a", layout);
+
+	if (expression.run(values) != 31) {
+		std::cout << "Incorrect shared layout result for: c * 10 + a" << std::endl;
+	}
+
+	// Errors while running are reported at the failing operator
+	try {
+		evaluator.compile("a + c % (b - 2)", layout).run(values);
+		std::cout << "No exception thrown when running: a + c % (b - 2)\n" << std::endl;
+	} catch (const InfixParser::EvaluationException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+
+	try {
+		evaluator.compile("a + d", layout);
+		std::cout << "No exception thrown for unknown variable: a + d\n" << std::endl;
+	} catch (const InfixParser::EvaluationException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+}
+
+void optimize_tests(bool print) {
+	// Constant subexpressions are folded
+	Test::check_optimized("2^10*3", {}, 1, 3072);
+	Test::check_optimized("7 / 2 + x", {1}, 3, 5);
+	Test::check_optimized("-(3 - 5) * x", {4}, 3, 8);
+	Test::check_optimized("(1 < 2) + (2 >= 3) + !0", {}, 1, 2);
+
+	// Operators that fail on constants are left to fail when run
+	Test::check_equation_throws("1 / (2 - 2)", print);
+	Test::check_equation_throws("1 + 1 % 0 * 0", print);
+
+	// Unary chains
+	Test::check_optimized("- -x", {5}, 1, 5);
+	Test::check_optimized("--++x", {5}, 1, 5);
+	Test::check_optimized("----x", {5}, 3, 3);
+	Test::check_optimized("!!!x", {5}, 2, 0);
+	Test::check_optimized("!!x", {5}, 3, 1);
+
+	// Identities
+	Test::check_optimized("x * 1 + 0", {6}, 1, 6);
+	Test::check_optimized("1 * (0 + x)", {6}, 1, 6);
+	Test::check_optimized("x / 1 - 0", {6}, 1, 6);
+	Test::check_optimized("x ^ 1", {6}, 1, 6);
+	Test::check_optimized("(x + y) * 0", {6, 7}, 1, 0);
+	Test::check_optimized("x && 0", {6}, 1, 0);
+	Test::check_optimized("0 && x", {6}, 1, 0);
+	Test::check_optimized("x > 2 || 3", {6}, 1, 1);
+
+	// Subexpressions that could fail are never dropped unless they would be skipped
+	Test::check_optimized("x / y && 0", {6, 2}, 6, 0);
+	Test::check_optimized("0 && x / y", {6, 0}, 1, 0);
+	Test::check_optimized("1 || x % y", {6, 0}, 1, 1);
+	Test::check_optimized("1 && 5", {}, 1, 1);
+	Test::check_optimized("0 || x", {6}, 4, 1);
+}
+
+void short_circuit_tests(bool print) {
+	// The right side is skipped when the left side decides the result
+	Test::check_equation("0 && 1 / 0", 0);
+	Test::check_equation("3 || 1 % 0", 1);
+	Test::check_equation("(2 > 1 || 1 / 0) + (1 < 0 && 1 / 0) * 5", 1);
+	Test::check_equation_throws("1 && 1 / 0", print);
+	Test::check_equation_throws("0 || 1 / 0", print);
+
+	// The result is always 0 or 1
+	Test::check_compiled("a && b", {3, 4}, 1);
+	Test::check_compiled("a || b", {3, 0}, 1);
+	Test::check_compiled("a || b", {0, -7}, 1);
+	Test::check_compiled("a && b || c && d", {0, 5, 2, 0}, 0);
+	Test::check_compiled("!(a || b) && c", {0, 0, 9}, 1);
+
+	// Guards protect the right side when running compiled expressions
+	Test::check_compiled("b != 0 && a / b > 1", {0, 9}, 0);
+	Test::check_compiled("b == 0 || a % b == 1", {0, 9}, 1);
+	Test::check_compiled("a && (b || c / a) && d", {0, 0, 1, 1}, 0);
+
+	// Batches skip the right side only for the rows the left side decides
+	for (size_t rows : {1, 7, 256, 1000}) {
+		Test::check_batch("a != 0 && 100 / a > 3", rows);
+		Test::check_batch("a == 0 || b % a > 2 && (c == 0 || b / c)", rows);
+		Test::check_batch("(a > 0 && b) + (b > 0 || c) * 2", rows);
+	}
+
+	Test::check_filter("a != 0 && 100 / a > 3 || b == 0 || 7 % b", 1000);
+}
+
+void function_tests(bool print) {
+	using InfixParser::Error;
+
+	// Built-in functions bind tighter than any operator and may be nested
+	Test::check_equation("abs(-5)", 5);
+	Test::check_equation("abs(3 - 10) * 2", 14);
+	Test::check_equation("-abs(2 - 5) ^ 2", 9);
+	Test::check_equation("min(3, 2) + max(3, 2)", 5);
+	Test::check_equation("max(min(1, 2), 3 * 2)", 6);
+	Test::check_equation("min(1, -max(2, 3))", -3);
+	Test::check_equation("clamp(15, 0, 10)", 10);
+	Test::check_equation("clamp(-4, 0, 10) + clamp(4, 0, 10)", 4);
+	Test::check_equation("clamp(5, 10, 0)", 0);
+	Test::check_equation("abs (-2) + max( 1 , (2 + 3) )", 7);
+	Test::check_equation("abs(-2147483647 - 1)", -2147483647 - 1);
+	Test::check_equation("max(1 > 0 && 2, 0 || 0)", 1);
+	Test::check_equation("abs(0-3) - 1", 2);
+	Test::check_equation("max(1,2) - 1 -min(4, 5)", -3);
+	Test::check_equation("(1) - 2 - abs(-4) -(-3)", -2);
+	Test::check_compiled("abs(x) - 1", {-6}, 5);
+	Test::check_compiled("min(a,b) - 1", {4, 9}, 3);
+
+	// Calls must have exactly the arguments of their function, and commas must separate them
+	Test::check_error("abs(1, 2)", Error::WRONG_ARGUMENT_COUNT, 8, print);
+	Test::check_error("2 + min(1)", Error::WRONG_ARGUMENT_COUNT, 9, print);
+	Test::check_error("clamp(1, 2, 3, 4)", Error::WRONG_ARGUMENT_COUNT, 16, print);
+	Test::check_error("1, 2", Error::MISPLACED_COMMA, 1, print);
+	Test::check_error("min((1, 2), 3)", Error::MISPLACED_COMMA, 6, print);
+	Test::check_error("abs()", Error::EXPECTED_OPERAND, 4, print);
+	Test::check_error("min(1,, 2)", Error::EXPECTED_OPERAND, 6, print);
+	Test::check_error("abs + 1", Error::UNKNOWN_VARIABLE, 2, print);
+	Test::check_error("2 abs(1)", Error::EXPECTED_OPERATOR, 1, print);
+
+	// Names that are not called are still variables
+	Test::check_compiled("min + max(min, abs)", {5, -7}, 10);
+
+	// Each call is a single instruction, and calls of constants are folded
+	Test::check_optimized("max(a, b)", {3, 4}, 3, 4);
+	Test::check_optimized("clamp(a, 0, 100) + abs(-3)", {250}, 6, 103);
+	Test::check_optimized("min(2, 3) * a", {7}, 3, 14);
+
+	// Checked arithmetic reports the absolute value that does not fit
+	InfixParser::Evaluator checked;
+	checked.set_checked(true);
+
+	if (checked.try_evaluate("abs(-2147483647 - 1)").error != Error::INTEGER_OVERFLOW || checked.evaluate("abs(-2147483647)") != 2147483647) {
+		std::cout << "Incorrect checked result for equation: abs(-2147483647 - 1)" << std::endl;
+	}
+
+	// Doubles compare without rounding
+	InfixParser::DoubleEvaluator real;
+
+	for (const auto& [equation, expected] : {std::pair{"abs(1 / 4 - 1)", 0.75}, std::pair{"min(1 / 3, 1 / 4)", 0.25}, std::pair{"clamp(7 / 2, 0, 10)", 3.5}}) {
+		const auto result = real.try_evaluate(equation);
+
+		if (!result.ok() || result.value != expected) {
+			std::cout << "Incorrect double result for equation: " << equation << " is " << result.value << " not " << expected << std::endl;
+		}
+	}
+}
+
+void arithmetic_tests(bool print) {
+	// Integer arithmetic rounds the same way as rounding the exact result did
+	for (int left = -300; left <= 300; left += 7) {
+		for (int right = -40; right <= 40; ++right) {
+			if (right != 0 && InfixParser::Arithmetic::divide(left, right) != static_cast<int>(std::round(static_cast<double>(left) / right))) {
+				std::cout << "Incorrect rounding for " << left << " / " << right << std::endl;
+			}
+
+			const auto exact = std::round(std::pow(static_cast<double>(left), static_cast<double>(right)));
+
+			if (left != 0 && std::abs(exact) <= 2147483647.0 && InfixParser::Arithmetic::power(left, right) != static_cast<int>(exact)) {
+				std::cout << "Incorrect power for " << left << " ^ " << right << std::endl;
+			}
+		}
+	}
+
+	Test::check_equation("7 / 2 + -7 / 2 + 7 / -2", -4);
+	Test::check_equation("2147483647 / 2", 1073741824);
+	Test::check_equation("2147483647 / -2147483647", -1);
+	Test::check_equation("2 ^ 30", 1073741824);
+	Test::check_equation("-3 ^ 19", -1162261467);
+	Test::check_equation("2 ^ -1 + -2 ^ -1 + 3 ^ -1", 0);
+	Test::check_equation("-1 ^ -3 + 1 ^ -7", 0);
+	Test::check_equation("0 ^ 0", 1);
+	Test::check_equation_throws("0 ^ -1", print);
+
+	// Results that do not fit wrap by default
+	Test::check_equation("2147483647 + 1", -2147483647 - 1);
+	Test::check_equation("-(-2147483647 - 1) / -1", -2147483647 - 1);
+	Test::check_equation("(-2147483647 - 1) % -1", 0);
+	Test::check_equation("2 ^ 32 + 3 ^ 21", 1870418611);
+
+	// Checked arithmetic reports them instead
+	InfixParser::Evaluator evaluator;
+	evaluator.set_checked(true);
+
+	for (const char* equation : {"2147483647 + 1", "-2147483647 - 2", "46341 * 46341", "-(-2147483647 - 1)", "++2147483647", "--(-2147483647 - 1)", "2 ^ 31", "(-2147483647 - 1) / -1", "3 ^ 4 ^ 5"}) {
+		const auto result = evaluator.try_evaluate(equation);
+
+		if (result.error != InfixParser::Error::INTEGER_OVERFLOW) {
+			std::cout << "No overflow reported for equation: " << equation << " value given " << result.value << std::endl;
+		} else if (print) {
+			std::cout << result.message(equation) << std::endl;
+		}
+	}
+
+	for (const auto& [equation, expected] : {std::pair{"46340 * 46340", 2147395600}, std::pair{"-2147483647 - 1", -2147483647 - 1}, std::pair{"-2 ^ 31", -2147483647 - 1}, std::pair{"1 ^ 2147483647", 1}}) {
+		const auto result = evaluator.try_evaluate(equation);
+
+		if (!result.ok() || result.value != expected) {
+			std::cout << "Incorrect checked result for equation: " << equation << " is " << result.value << " not " << expected << std::endl;
+		}
+	}
+
+	// Compiled expressions check every way they are run, and never cancel operators that could overflow
+	const auto expression = evaluator.compile("--++a * b");
+	std::vector<int> a(300, 2);
+	std::vector<int> b(300, 3);
+	std::vector<int> results(300);
+	const int* columns[] = {a.data(), b.data()};
+	b[257] = 1 << 30;
+
+	try {
+		expression.run_batch(columns, results.data(), a.size());
+		std::cout << "No exception thrown for overflow in row 257" << std::endl;
+	} catch (const InfixParser::EvaluationException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+
+	const int values[] = {2147483647, 1};
+
+	try {
+		expression.run(values);
+		std::cout << "No exception thrown for overflow in --++a" << std::endl;
+	} catch (const InfixParser::EvaluationException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+}
+
+void numeric_type_tests() {
+	// 64 bit integers hold results that overflow an int
+	InfixParser::Int64Evaluator int64;
+
+	for (const auto& [equation, expected] : {std::pair{"2147483647 + 1", int64_t{2147483648}}, std::pair{"3 ^ 39", int64_t{4052555153018976267}}, std::pair{"-9223372036854775807 - 1", INT64_MIN}}) {
+		const auto result = int64.try_evaluate(equation);
+
+		if (!result.ok() || result.value != expected) {
+			std::cout << "Incorrect int64 result for equation: " << equation << " is " << result.value << " not " << expected << std::endl;
+		}
+	}
+
+	int64.set_checked(true);
+
+	for (const char* equation : {"9223372036854775807 + 1", "3 ^ 40", "(-9223372036854775807 - 1) / -1"}) {
+		if (int64.try_evaluate(equation).error != InfixParser::Error::INTEGER_OVERFLOW) {
+			std::cout << "No int64 overflow reported for equation: " << equation << std::endl;
+		}
+	}
+
+	if (int64.try_evaluate("9223372036854775808").error != InfixParser::Error::NUMBER_TOO_LARGE) {
+		std::cout << "No error reported for an int64 literal that is too large" << std::endl;
+	}
+
+#if defined(INFIXPARSER_INT128)
+	InfixParser::Int128Evaluator int128;
+
+	if (int128.evaluate("2 ^ 100 + 170141183460469231731687303715884105727 % 10") != (static_cast<__int128>(1) << 100) + 7) {
+		std::cout << "Incorrect int128 result for equation: 2 ^ 100 + 170141183460469231731687303715884105727 % 10" << std::endl;
+	}
+#endif
+
+	// Doubles do not round division and use fmod and pow, so a negative power of zero is infinite
+	InfixParser::DoubleEvaluator real;
+
+	for (const auto& [equation, expected] : {std::pair{"1 / 2", 0.5}, std::pair{"7 % 2 + -7 % 2", 0.0}, std::pair{"2 ^ -1", 0.5}, std::pair{"10 / 4 * 2", 5.0}, std::pair{"1 / 3 > 0", 1.0}, std::pair{"(0 - 3) / 4", -0.75},
+		std::pair{"0 ^ -1", HUGE_VAL}, std::pair{"1 - 0 ^ -2", -HUGE_VAL}}) {
+		const auto result = real.try_evaluate(equation);
+
+		if (!result.ok() || result.value != expected) {
+			std::cout << "Incorrect double result for equation: " << equation << " is " << result.value << " not " << expected << std::endl;
+		}
+	}
+
+	// Literals only need to fit in a double
+	if (real.evaluate("100000000000000000000 / 4") != 25000000000000000000.0) {
+		std::cout << "Incorrect double result for equation: 100000000000000000000 / 4" << std::endl;
+	}
+
+	if (real.try_evaluate(std::string(400, '9')).error != InfixParser::Error::NUMBER_TOO_LARGE) {
+		std::cout << "No error reported for a double literal that is too large" << std::endl;
+	}
+
+	// Compiled expressions do not apply identities that only hold for integers
+	const auto expression = real.compile("a * 0 + --++b + c / d");
+	const double values[] = {INFINITY, 9007199254740993.0, 1, 4};
+	const auto value = expression.run(values);
+
+	if (!std::isnan(value)) {
+		std::cout << "Incorrect compiled double result: " << value << " not nan" << std::endl;
+	}
+
+	const double zero[] = {0, -3};
+	real.set_checked(true);
+
+	if (real.compile("a ^ b").run(zero) != INFINITY || real.compile("a ^ -1").run(zero) != INFINITY) {
+		std::cout << "Incorrect compiled double result for a negative power of zero" << std::endl;
+	}
+
+	real.set_checked(false);
+
+	const double a[] = {1, 2, 3};
+	const double b[] = {0.5, 0.25, 8};
+	const double* columns[] = {a, b};
+	double results[3];
+	real.compile("a / b").run_batch(columns, results, 3);
+
+	if (results[0] != 2 || results[1] != 8 || results[2] != 0.375) {
+		std::cout << "Incorrect double batch results: " << results[0] << ", " << results[1] << ", " << results[2] << std::endl;
+	}
+}
+
+/**
+ * @brief Checks if InfixParser::eval gives @p equation the same value or exception as InfixParser::Evaluator::evaluate.
+ * @param[in] equation The equation to check.
+ */
+template<size_t N>
+void check_constant(const char (&equation)[N]) {
+	InfixParser::Evaluator evaluator;
+	std::string expected;
+	std::string actual;
+
+	try {
+		expected = std::to_string(evaluator.evaluate(equation));
+	} catch (const InfixParser::EvaluationException& except) {
+		expected = except.what();
+	}
+
+	try {
+		actual = std::to_string(InfixParser::eval(equation));
+	} catch (const InfixParser::EvaluationException& except) {
+		actual = except.what();
+	}
+
+	if (actual != expected) {
+		std::cout << "Incorrect constant result for equation: " << equation << " is " << actual << " not " << expected << std::endl;
+	}
+}
+
+void constant_tests(bool print) {
+	// Evaluated by the compiler
+	static_assert(InfixParser::eval("(2+3)*5") == 25);
+	static_assert(InfixParser::eval("++++2-5*(3^2)") == -41);
+	static_assert(InfixParser::eval("-2 + (3%5)^3*-1 + ++3") == -25);
+	static_assert(InfixParser::eval("0 && 1 / 0 || !(2 ^ -1 != 1)") == 1);
+	static_assert(InfixParser::eval("7 / 2 + -7 / 2 + 7 / -2") == -4);
+	static_assert(InfixParser::eval("2147483647 + 1") == -2147483647 - 1);
+	static_assert(InfixParser::eval<int64_t>("3 ^ 39") == 4052555153018976267);
+	static_assert(InfixParser::eval("max(abs(-7), min(2, 3)) + clamp(12, 0, 10)") == 17);
+
+	// The same values and errors as the runtime path
+	check_constant("(3==-2&&1!=0) || -39==-39");
+	check_constant("(1) - 2 -(-3)");
+	check_constant("(2 * 3) -1 - (4)-(5)");
+	check_constant("(1) 2");
+	check_constant("1 || 1 / 0 && 2 % 0");
+	check_constant("--(-2147483647 - 1) ^ 3 % 7");
+	check_constant(")3+2");
+	check_constant("3&&&&5");
+	check_constant("15+3 2");
+	check_constant("10+ ++<3");
+	check_constant("1/0");
+	check_constant("0 ^ -1");
+	check_constant("(3-2)++1");
+	check_constant("3-!");
+	check_constant("2 + x");
+	check_constant("2 ? 3");
+	check_constant("3 % 0");
+	check_constant("3 = 2");
+	check_constant("(1 + 2");
+	check_constant("1 + 2)");
+	check_constant("2147483648");
+	check_constant("-abs(2 - 5) ^ 2 + clamp(-4, -2, max(1, 2))");
+	check_constant("(1) - 2 - abs(-4) -(-3)");
+	check_constant("max(1,2) - 1 -min(4, 5)");
+	check_constant("abs(1, 2)");
+	check_constant("min((1, 2), 3)");
+	check_constant("1, 2");
+	check_constant("abs + 1");
+	check_constant("2 + min(1)");
+	check_constant("");
+
+	if (print) {
+		try {
+			InfixParser::eval("1 + * 2");
+		} catch (const InfixParser::EvaluationException& except) {
+			std::cout << except.what() << std::endl;
+		}
+	}
+}
+
+void batch_tests(bool print) {
+	// Row counts that are and are not multiples of the block and vector sizes
+	for (size_t rows : {1, 7, 256, 1000}) {
+		Test::check_batch("a + b * c - 3", rows);
+		Test::check_batch("-a + !b + ++c + --a", rows);
+		Test::check_batch("a ^ 2 - b ^ 3", rows);
+		Test::check_batch("a / 7 + b % 5 + 100 / (c * c + 1)", rows);
+		Test::check_batch("(a > b) + (a >= b) + (a < b) + (a <= b) + (a == b) + (a != b)", rows);
+		Test::check_batch("a && b || !c && a", rows);
+		Test::check_batch("min(a, b) + max(b, c) + abs(a - c) + clamp(a, -3, b)", rows);
+		Test::check_batch("42", rows);
+	}
+
+	// Errors report the row they occured in
+	InfixParser::Evaluator evaluator;
+	const auto expression = evaluator.compile("a / b");
+	const int a[] = {1, 2, 3};
+	const int b[] = {1, 0, 1};
+	const int* columns[] = {a, b};
+	int results[3];
+
+	try {
+		expression.run_batch(columns, results, 3);
+		std::cout << "No exception thrown for batch: a / b\n" << std::endl;
+	} catch (const InfixParser::EvaluationException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+}
+
+void filter_tests(bool print) {
+	for (size_t rows : {1, 100, 256, 1000}) {
+		Test::check_filter("a > 0", rows);
+		Test::check_filter("a > 0 && b < 5", rows);
+		Test::check_filter("a > 0 || b < -5 && c != 3", rows);
+		Test::check_filter("!(a == b || a > 10) && (c <= 0 || !b)", rows);
+		Test::check_filter("(a > b) + (b > c) >= 1 && a % 3", rows);
+		Test::check_filter("abs(a - b) < clamp(c, 1, 5) && max(a, b) > 0", rows);
+		Test::check_filter("0", rows);
+		Test::check_filter("1", rows);
+	}
+
+	// The right side of a guard is not run for rows that fail the left side
+	InfixParser::Evaluator evaluator;
+	const auto expression = evaluator.compile("b != 0 && a / b > 1", {"a", "b"});
+	const int a[] = {9, 9, 9, 9};
+	const int b[] = {0, 3, 0, 9};
+	const int* columns[] = {a, b};
+	std::vector<size_t> selection;
+
+	try {
+		expression.filter(columns, 4, selection);
+
+		if (selection != std::vector<size_t>{1}) {
+			std::cout << "Incorrect guarded filter selection: b != 0 && a / b > 1" << std::endl;
+		}
+	} catch (const InfixParser::EvaluationException& except) {
+		std::cout << "Exception thrown for guarded filter: b != 0 && a / b > 1" << std::endl;
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+}
+
+void expression_set_tests(bool print) {
+	// Expressions that share subexpressions, in any operand order, and that share none
+	for (size_t rows : {1, 7, 256, 1000}) {
+		Test::check_expression_set({"(a + b) * c > d", "(a + b) * c - e", "c * (b + a)", "max(a, b) + min(b, a)"}, rows);
+		Test::check_expression_set({"a && b || !c && a", "a && b", "!c && a || -b"}, rows);
+		Test::check_expression_set({"a / 7 + b % 5 + 100 / (c * c + 1)", "100 / (c * c + 1) - abs(a)", "clamp(a, -3, b) ^ 2"}, rows);
+		Test::check_expression_set({"42", "a", "a - 42", "a * a"}, rows);
+	}
+
+	InfixParser::Evaluator evaluator;
+	const InfixParser::ExpressionSet set{{
+		evaluator.compile("(a + b) * c > d"),
+		evaluator.compile("(a + b) * c - e"),
+		evaluator.compile("c * (b + a)"),
+		evaluator.compile("max(a, b) + min(b, a)"),
+	}};
+
+	// Each distinct subexpression is counted once
+	const auto statistics = set.statistics();
+
+	if (statistics.expressions != 4 || statistics.operations != 11 || statistics.shared_operations != 7 || statistics.nodes != 12) {
+		std::cout << "Incorrect expression set statistics: " << statistics.operations << " operations shared as " << statistics.shared_operations << std::endl;
+	}
+
+	if (set.variables() != std::vector<std::string>{"a", "b", "c", "d", "e"}) {
+		std::cout << "Incorrect expression set variables" << std::endl;
+	}
+
+	// Errors are only reported for the sides of && and || each expression runs, and report the row they occured in
+	const InfixParser::ExpressionSet guarded{{
+		evaluator.compile("b != 0 && a / b > 1"),
+		evaluator.compile("b == 0 || a % b == 0"),
+	}};
+
+	const int a[] = {9, 9, 9, 9};
+	const int b[] = {0, 3, 0, 9};
+	const int* columns[] = {b, a}; // In the order of guarded.variables()
+	int guards[2][4];
+	int* results[] = {guards[0], guards[1]};
+
+	try {
+		guarded.run_batch(columns, results, 4);
+
+		if (guards[0][1] != 1 || guards[0][2] != 0 || guards[1][0] != 1 || guards[1][3] != 1) {
+			std::cout << "Incorrect guarded expression set results" << std::endl;
+		}
+	} catch (const InfixParser::EvaluationException& except) {
+		std::cout << "Exception thrown for guarded expression set" << std::endl;
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+
+	const InfixParser::ExpressionSet unguarded{{evaluator.compile("a + b"), evaluator.compile("a / b")}};
+
+	try {
+		const int* unguarded_columns[] = {a, b};
+		unguarded.run_batch(unguarded_columns, results, 4);
+		std::cout << "No exception thrown for expression set: a / b" << std::endl;
+	} catch (const InfixParser::EvaluationException& except) {
+		if (std::string{except.what()}.find("(row 0)") == std::string::npos) {
+			std::cout << "Incorrect expression set error row: " << except.what() << std::endl;
+		}
+
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+
+	// Other value types apply each operator one row at a time
+	InfixParser::DoubleEvaluator real;
+	const InfixParser::BasicExpressionSet<double> reals{{real.compile("(x + y) / 2"), real.compile("(y + x) / 2 * x")}};
+	const double values[] = {1.5, 2.5};
+	double averages[2];
+	reals.run(values, averages);
+
+	if (averages[0] != 2.0 || averages[1] != 3.0 || reals.statistics().shared_operations != 3) {
+		std::cout << "Incorrect double expression set results" << std::endl;
+	}
+
+	// The min and max of doubles return their left operand for NaN and zeros of either sign, so their operands are not reordered
+	const InfixParser::BasicExpressionSet<double> ordered{{real.compile("min(a, b)"), real.compile("min(b, a)"), real.compile("max(a, b)"), real.compile("max(b, a)")}};
+	const double unordered[] = {std::numeric_limits<double>::quiet_NaN(), 1.0};
+	const double zeros[] = {0.0, -0.0};
+	double extremes[4];
+	ordered.run(unordered, extremes);
+
+	if (!std::isnan(extremes[0]) || extremes[1] != 1.0 || !std::isnan(extremes[2]) || extremes[3] != 1.0) {
+		std::cout << "Incorrect double expression set NaN results: " << extremes[0] << ", " << extremes[1] << ", " << extremes[2] << ", " << extremes[3] << std::endl;
+	}
+
+	ordered.run(zeros, extremes);
+
+	if (std::signbit(extremes[0]) || !std::signbit(extremes[1]) || std::signbit(extremes[2]) || !std::signbit(extremes[3])) {
+		std::cout << "Incorrect double expression set signed zero results: " << extremes[0] << ", " << extremes[1] << ", " << extremes[2] << ", " << extremes[3] << std::endl;
+	}
+}
+
+void pack_tests(bool print) {
+	const auto path = (std::filesystem::temp_directory_path() / "InfixParserTest.pack").string();
+	const std::vector<std::string> equations = {
+		"a + b * c - 3",
+		"-a + !b + ++c + --a ^ 2",
+		"a && (b || c / a) && d",
+		"a == 0 || b % a > 2 && (c == 0 || b / c)",
+		"min(a, b) + max(b, c) + abs(a - c) + clamp(a, -3, b)",
+		"42",
+		"d",
+	};
+
+	InfixParser::Evaluator evaluator;
+	std::vector<InfixParser::CompiledExpression> expressions;
+
+	for (const auto& equation : equations) {
+		expressions.push_back(evaluator.compile(equation));
+	}
+
+	evaluator.set_checked(true);
+	expressions.push_back(evaluator.compile("a * 65536 * b"));
+	expressions.push_back(evaluator.compile("a / b"));
+
+	// Every expression runs the same from the pack as it was compiled
+	InfixParser::ExpressionPack::write(path, expressions);
+
+	{
+		const InfixParser::ExpressionPack pack{path};
+		InfixParser::OperandStack operands;
+
+		if (pack.size() != expressions.size()) {
+			std::cout << "Incorrect pack size: " << pack.size() << std::endl;
+		}
+
+		for (size_t i = 0; i < expressions.size(); ++i) {
+			const auto& expression = expressions[i];
+			const auto variables = pack.variables(i);
+
+			if (pack.equation(i) != expression.equation() || !std::equal(variables.cbegin(), variables.cend(), expression.variables().cbegin(), expression.variables().cend())) {
+				std::cout << "Incorrect packed equation: " << pack.equation(i) << std::endl;
+			}
+
+			if (pack.expression(i).instructions().size() != expression.instructions().size()) {
+				std::cout << "Incorrect unpacked expression: " << expression.equation() << std::endl;
+			}
+
+			for (const auto& values : {std::vector<int>{0, 0, 0, 0}, std::vector<int>{3, -5, 7, 1}, std::vector<int>{40000, 40000, 2, 0}}) {
+				const auto expected = expression.try_run(values.data(), operands);
+				const auto result = pack.try_run(i, values.data(), operands);
+
+				if (result.value != expected.value || result.error != expected.error || result.position != expected.position) {
+					std::cout << "Incorrect packed result: " << expression.equation() << " is " << result.value << " not " << expected.value << std::endl;
+				}
+			}
+		}
+
+		// Errors are reported against the packed equation
+		try {
+			const int values[] = {1, 0};
+			pack.run(expressions.size() - 1, values, operands);
+			std::cout << "No exception thrown for packed expression: a / b" << std::endl;
+		} catch (const InfixParser::EvaluationException& except) {
+			if (print) { std::cout << except.what() << std::endl; }
+		}
+	}
+
+	// Packs that are damaged or were written for something else are rejected
+	std::string contents;
+
+	{
+		std::ifstream input{path, std::ios::binary};
+		contents.assign(std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{});
+	}
+
+	const auto check_rejected = [&](const std::string& description, const std::string& damaged) {
+		std::ofstream{path, std::ios::binary | std::ios::trunc}.write(damaged.data(), static_cast<std::streamsize>(damaged.size()));
+
+		try {
+			InfixParser::ExpressionPack pack{path};
+			std::cout << "No exception thrown for " << description << " pack" << std::endl;
+		} catch (const InfixParser::ExpressionPackException& except) {
+			if (print) { std::cout << except.what() << std::endl; }
+		}
+	};
+
+	auto corrupt = contents;
+	corrupt[contents.size() / 2] ^= 0x10;
+	check_rejected("a corrupt", corrupt);
+	check_rejected("a truncated", contents.substr(0, contents.size() - 1));
+	check_rejected("an empty", "");
+	check_rejected("a text", "1 + 2\n3 * 4\n");
+
+	auto future = contents;
+	future[8] = 2;
+	check_rejected("a future version", future);
+
+	std::ofstream{path, std::ios::binary | std::ios::trunc}.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+	try {
+		InfixParser::BasicExpressionPack<int64_t> pack{path};
+		std::cout << "No exception thrown for a pack of another value type" << std::endl;
+	} catch (const InfixParser::ExpressionPackException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+
+	// Registered operators have no stable identity to save
+	InfixParser::OperatorRegistry registry;
+	registry.add("<<", 5, false, 2, [](InfixParser::OperandStack& operands) {
+		const auto right = operands.top();
+		operands.pop();
+		operands.top() <<= right;
+		return InfixParser::Error::NONE;
+	});
+	registry.freeze();
+
+	InfixParser::Evaluator shifts{registry};
+
+	try {
+		InfixParser::ExpressionPack::write(path, {shifts.compile("a << 2")});
+		std::cout << "No exception thrown for packing a registered operator" << std::endl;
+	} catch (const InfixParser::ExpressionPackException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+
+	std::filesystem::remove(path);
+}
+
+void cache_tests(bool print) {
+	InfixParser::ExpressionCache cache{4, 1};
+
+	// Repeated lookups share the same expression
+	auto first = cache.get("1 + 2");
+	auto second = cache.get("1 + 2");
+
+	if (first != second || first->run() != 3) {
+		std::cout << "Incorrect cached expression: 1 + 2" << std::endl;
+	}
+
+	// Ill formed equations are reported and not cached
+	try {
+		cache.get("1 +");
+		std::cout << "No exception thrown for cached equation: 1 +\n" << std::endl;
+	} catch (const InfixParser::EvaluationException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+
+	// The cache is bounded and evicted expressions remain usable
+	for (int i = 0; i < 10; ++i) {
+		cache.get(std::to_string(i) + " * 2");
+	}
+
+	auto stats = cache.statistics();
+
+	if (stats.size != 4 || stats.evictions != 7 || stats.hits != 1 || stats.misses != 12 || first->run() != 3) {
+		std::cout << "Incorrect cache statistics: " << stats.size << " cached, " << stats.evictions << " evictions, " << stats.hits << " hits, " << stats.misses << " misses" << std::endl;
+	}
+
+	// Concurrent lookups of the same equations
+	InfixParser::ExpressionCache shared_cache{64};
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&shared_cache]{
+			for (int i = 0; i < 1000; ++i) {
+				const auto value = i % 8;
+
+				if (shared_cache.get("x + " + std::to_string(value))->run(&value) != value * 2) {
+					std::cout << "Incorrect concurrently cached expression" << std::endl;
+				}
+			}
+		});
+	}
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	stats = shared_cache.statistics();
+
+	if (stats.size != 8 || stats.hits + stats.misses != 4000 || stats.evictions != 0) {
+		std::cout << "Incorrect concurrent cache statistics: " << stats.size << " cached, " << stats.hits << " hits, " << stats.misses << " misses" << std::endl;
+	}
+}
+
+void formula_graph_tests(bool print) {
+	InfixParser::ThreadPool pool{4};
+	InfixParser::FormulaGraph graph{pool};
+
+	const auto check_value = [&](const std::string& name, int expected) {
+		try {
+			if (graph.value(name) != expected) {
+				std::cout << "Incorrect formula value for " << name << ": " << graph.value(name) << " not " << expected << std::endl;
+			}
+		} catch (const std::exception& except) {
+			std::cout << "Exception thrown for formula value " << name << ": " << except.what() << std::endl;
+		}
+	};
+
+	const auto check_recomputed = [&](size_t expected, const std::string& description) {
+		if (graph.recomputed() != expected) {
+			std::cout << "Incorrect number of formulas recomputed after " << description << ": " << graph.recomputed() << " not " << expected << std::endl;
+		}
+	};
+
+	// Formulas can reference names before they are set, which are inputs of 0 until then
+	graph.set("a", 1);
+	graph.define("c", "a + b");
+	graph.define("d", "c * 2");
+	graph.define("e", "max(d, a)");
+	graph.define("f", "a > 0");
+	graph.define("g", "f + 1");
+	graph.set("b", 2);
+	graph.recompute();
+	check_value("c", 3);
+	check_value("d", 6);
+	check_value("e", 6);
+	check_value("g", 2);
+
+	// Only the formulas downstream of a change are recomputed, and not past one whose value is unchanged
+	graph.set("a", 5);
+	graph.recompute();
+	check_value("d", 14);
+	check_value("e", 14);
+	check_recomputed(4, "setting a");
+
+	graph.set("b", 2);
+	graph.recompute();
+	check_recomputed(0, "setting b to its value");
+
+	graph.define("b", "a - 4");
+	graph.recompute();
+	check_value("e", 12);
+	check_recomputed(4, "defining b");
+
+	// Definitions that would create a cycle are rejected and leave the graph unchanged
+	for (const auto& [name, equation] : {std::pair{"a", "e + 1"}, std::pair{"h", "h"}, std::pair{"c", "e + g"}}) {
+		try {
+			graph.define(name, equation);
+			std::cout << "No exception thrown for a cycle defining " << name << " as " << equation << std::endl;
+		} catch (const InfixParser::FormulaGraphException& except) {
+			if (print) { std::cout << except.what() << std::endl; }
+		}
+	}
+
+	graph.recompute();
+	check_recomputed(0, "rejected definitions");
+	check_value("c", 6);
+
+	if (graph.contains("h") || graph.size() != 7) {
+		std::cout << "Rejected formula added to the graph" << std::endl;
+	}
+
+	// Errors pass to the formulas that depend on them and are reported against the formula they occured in
+	graph.define("h", "c / (a - 5)");
+	graph.define("i", "h + 1");
+	graph.recompute();
+
+	if (graph.result("i").error != InfixParser::Error::DIVISION_BY_ZERO) {
+		std::cout << "Incorrect formula error for i" << std::endl;
+	}
+
+	try {
+		graph.value("i");
+		std::cout << "No exception thrown for a failed formula" << std::endl;
+	} catch (const InfixParser::EvaluationException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+
+	graph.set("a", 6);
+	graph.recompute();
+	check_value("i", 9);
+
+	// Wide waves are split across the pool
+	InfixParser::FormulaGraph wide{pool};
+	wide.set("x", 1);
+
+	for (int i = 0; i < 5000; ++i) {
+		wide.define("a" + std::to_string(i), "x * " + std::to_string(i));
+		wide.define("b" + std::to_string(i), "a" + std::to_string(i) + " + a" + std::to_string((i + 1) % 5000));
+	}
+
+	wide.recompute();
+	wide.set("x", 3);
+	wide.recompute();
+
+	for (int i : {0, 1, 2500, 4999}) {
+		if (wide.value("b" + std::to_string(i)) != 3 * (i + (i + 1) % 5000)) {
+			std::cout << "Incorrect wide formula value for b" << i << std::endl;
+		}
+	}
+
+	if (wide.recomputed() != 10000) {
+		std::cout << "Incorrect number of wide formulas recomputed: " << wide.recomputed() << std::endl;
+	}
+
+	try {
+		graph.value("unknown");
+		std::cout << "No exception thrown for an unknown formula" << std::endl;
+	} catch (const InfixParser::FormulaGraphException& except) {
+		if (print) { std::cout << except.what() << std::endl; }
+	}
+}
+
+void allocation_tests(bool print) {
+	// Equations may be read directly out of a larger buffer
+	const char buffer[] = "(1+2)*3;++++2-5*(3^2)";
+	InfixParser::Evaluator evaluator;
+
+	if (evaluator.evaluate(std::string_view{buffer, 7}) != 9 || evaluator.evaluate(std::string_view{buffer + 8}) != -41) {
+		std::cout << "Incorrect result for equations in a buffer" << std::endl;
+	}
+
+	// Deep expressions move their stacks to the heap once and are then reused
+	std::string deep;
+
+	for (int i = 0; i < 200; ++i) {
+		deep += "1+(";
+	}
+
+	deep += "1" + std::string(200, ')');
+	Test::check_equation(deep, 201);
+	Test::check_no_allocations(deep);
+
+	// Warmed up evaluators do not allocate
+	Test::check_no_allocations("(3==-2&&1!=0) || -39==-39 + (((4 * 5)))");
+	Test::check_no_allocations("-2 + (3%5)^3*-1 + ++3");
+	Test::check_no_allocations("1");
+
+	// Running compiled expressions with shallow stacks does not allocate
+	const auto expression = evaluator.compile("a * (b + 3) > 10 && !c");
+	const int values[] = {2, 4, 0};
+	const auto before = Test::allocation_count();
+
+	if (expression.run(values) != 1 || Test::allocation_count() != before) {
+		std::cout << "Running a compiled expression allocated memory" << std::endl;
+	}
+
+	// Filtering allocates its buffers once, however many blocks and && or || splits there are
+	const auto predicate = evaluator.compile("a > 0 && b > 0 || !(c > 0) || a + b > c");
+	std::vector<int> column(4096);
+
+	for (size_t row = 0; row < column.size(); ++row) {
+		column[row] = static_cast<int>(row % 7) - 3;
+	}
+
+	const int* const columns[] = {column.data(), column.data() + 1, column.data() + 2};
+	std::vector<size_t> selection;
+	selection.reserve(column.size());
+
+	const auto filter_allocations = [&](size_t rows) {
+		const auto start = Test::allocation_count();
+		predicate.filter(columns, rows, selection);
+		return Test::allocation_count() - start;
+	};
+
+	if (filter_allocations(256) != filter_allocations(4000)) {
+		std::cout << "Filtering allocated memory for each block" << std::endl;
+	}
+
+	// So does running a batch in which && and || skip their right side for some rows
+	const auto guarded = evaluator.compile("a != 0 && 100 / a > 10 || (b > 0 && (c == 0 || b % c))");
+	std::vector<int> results(column.size());
+
+	const auto batch_allocations = [&](size_t rows) {
+		const auto start = Test::allocation_count();
+		guarded.run_batch(columns, results.data(), rows);
+		return Test::allocation_count() - start;
+	};
+
+	if (batch_allocations(256) != batch_allocations(4000)) {
+		std::cout << "Running a batch allocated memory for each block" << std::endl;
+	}
+
+	// Numbers that do not fit are reported instead of wrapping
+	Test::check_equation("2147483647", 2147483647);
+	Test::check_equation_throws("2147483648", print);
+	Test::check_equation_throws("1 + 99999999999999999999", print);
+}
+
+void registry_tests(bool print) {
+	using InfixParser::Error;
+	using InfixParser::OperandStack;
+
+	InfixParser::OperatorRegistry registry;
+
+	registry.add("<<", 5, false, 2, [](OperandStack& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		const auto right = operands.top();
+		operands.pop();
+		operands.top() = static_cast<int>(static_cast<unsigned>(operands.top()) << (right & 31));
+		return Error::NONE;
+	});
+
+	registry.add(">>", 5, false, 2, [](OperandStack& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		const auto right = operands.top();
+		operands.pop();
+		operands.top() >>= right & 31;
+		return Error::NONE;
+	});
+
+	registry.add("&", 2, false, 2, [](OperandStack& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		const auto right = operands.top();
+		operands.pop();
+		operands.top() &= right;
+		return Error::NONE;
+	});
+
+	registry.add("|", 1, false, 2, [](OperandStack& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		const auto right = operands.top();
+		operands.pop();
+		operands.top() |= right;
+		return Error::NONE;
+	});
+
+	registry.add("**", 7, true, 2, [](OperandStack& operands) {
+		return InfixParser::Operator::POWER.apply(operands);
+	});
+
+	registry.add("~", 8, true, 1, [](OperandStack& operands) {
+		if (operands.empty()) { return Error::MISSING_OPERANDS; }
+
+		operands.top() = ~operands.top();
+		return Error::NONE;
+	});
+
+	registry.freeze();
+
+	// Registered symbols are read by longest match, next to the predefined ones that share their prefix
+	InfixParser::Evaluator evaluator{registry};
+
+	for (const auto& [equation, expected] : {
+		std::pair{"1 << 4", 16}, std::pair{"1 << 2 + 1", 5}, std::pair{"256 >> 2 >> 1", 32}, std::pair{"2 < 1 << 2", 1}, std::pair{"1 <= 2", 1},
+		std::pair{"6 & 3 | 8", 10}, std::pair{"1 & 2 && 3", 0}, std::pair{"3 && 2 || 0", 1}, std::pair{"2 ** 3 ** 2", 512}, std::pair{"2 * 3 ** 2", 18},
+		std::pair{"-2 ** 2", 4}, std::pair{"~5", -6}, std::pair{"3 - ~0", 4}, std::pair{"~-1 + --2", 1}, std::pair{"!!3 != 0", 1}, std::pair{"3 *-2", -6},
+		std::pair{"2 **-1 + 1", 2}, std::pair{"7&3", 3},
+	}) {
+		const auto result = evaluator.try_evaluate(equation);
+
+		if (!result.ok() || result.value != expected) {
+			std::cout << "Incorrect registry result for equation: " << equation << " is " << result.value << " not " << expected << std::endl;
+		}
+	}
+
+	// Registered operators are applied when compiled, folded and run in batches
+	const auto expression = evaluator.compile("(a << b | c) + (2 ** 4 & 24)");
+	const int a[] = {1, 3, 5};
+	const int b[] = {4, 1, 0};
+	const int c[] = {0, 1, 2};
+	const int* columns[] = {a, b, c};
+	int results[3];
+	expression.run_batch(columns, results, 3);
+
+	if (expression.instructions().size() != 7 || results[0] != 32 || results[1] != 23 || results[2] != 23 || expression.run(a) != 29) {
+		std::cout << "Incorrect compiled registry result: " << results[0] << ", " << results[1] << ", " << results[2] << std::endl;
+	}
+
+	// A symbol may end the equation
+	if (const auto result = evaluator.try_evaluate("3 &"); result.error != InfixParser::Error::MISSING_OPERANDS || result.position != 2) {
+		std::cout << "Incorrect error for an equation ending in a symbol: " << result.message("3 &") << std::endl;
+	}
+
+	// The predefined operators are unchanged
+	Test::check_equation_throws("3 & 2", print);
+	Test::check_equation_throws("1 << 2", print);
+
+	// Invalid symbols, symbols that are taken and registries that are frozen are rejected
+	InfixParser::OperatorRegistry unfrozen;
+	const auto check_throws = [&](auto function, const std::string& description) {
+		try {
+			function();
+			std::cout << "No exception thrown for " << description << std::endl;
+		} catch (const InfixParser::OperatorRegistryException& except) {
+			if (print) { std::cout << except.what() << std::endl; }
+		}
+	};
+
+	for (const char* symbol : {"", "a+", "+1", " +", "+", "(", "&&"}) {
+		check_throws([&] { unfrozen.add(symbol, 1, false, 2, nullptr); }, "registering: " + std::string{symbol});
+	}
+
+	// A precedence of 0 would tie with ( and , and pop the ( of (1 # 2) * 3, and at most three operands fit in an instruction
+	for (const auto& [precedence, arity] : {std::pair{0, 2}, std::pair{-1, 2}, std::pair{1, 0}, std::pair{1, 4}, std::pair{1, -1}}) {
+		check_throws([&] { unfrozen.add("#", precedence, false, arity, nullptr); }, "registering # with precedence " + std::to_string(precedence) + " and arity " + std::to_string(arity));
+	}
+
+	check_throws([&] { unfrozen.add("-", InfixParser::Operator::CHECKED_NEGATE); }, "registering a second prefix -");
+	check_throws([&] { InfixParser::Evaluator{unfrozen}; }, "an evaluator of an unfrozen registry");
+	check_throws([&] { registry.add("<<<", 5, false, 2, nullptr); }, "registering into a frozen registry");
+
+	// The lowest precedence still leaves the ( of a group on the stack
+	unfrozen.add("#", 1, false, 2, [](OperandStack& operands) {
+		if (operands.size() < 2) { return Error::MISSING_OPERANDS; }
+
+		const auto right = operands.top();
+		operands.pop();
+		operands.top() -= right;
+		return Error::NONE;
+	});
+
+	unfrozen.freeze();
+
+	if (const auto result = InfixParser::Evaluator{unfrozen}.try_evaluate("(1 # 2) * 3"); !result.ok() || result.value != -3) {
+		std::cout << "Incorrect registry result for equation: (1 # 2) * 3 is " << result.value << " not -3" << std::endl;
+	}
+}
+
+void lexer_tests(bool print) {
+	// Runs that are shorter than, equal to and longer than a scanned chunk
+	for (size_t length : {1, 15, 16, 17, 33, 100}) {
+		const std::string spaces(length, ' ');
+		const std::string tabs(length, '\t');
+		const std::string zeros(length, '0');
+
+		Test::check_equation(spaces + "1" + tabs + "+" + spaces + tabs + "2" + spaces, 3);
+		Test::check_equation(zeros + "42 - " + zeros + "2", 40);
+		Test::check_equation(zeros, 0);
+	}
+
+	// Characters around a run are not consumed by it
+	Test::check_equation("                    12345678                    *2", 24691356);
+	Test::check_equation("1111111111 == 1111111111", true);
+	Test::check_equation_throws("                    1                   2", print);
+	Test::check_equation_throws("                    1                   \xE9", print);
+
+	// Every token in the table
+	Test::check_equation("2+3-1*4/2%3^1 > 0 >= 1 < 2 <= 3 == 1 != 0 && !0 || ++1 + --1 + -1 + (1)", true);
+}
+
+void stress_tests(bool print) {
+	InfixParser::Evaluator evaluator;
+
+	// Evaluates an equation and checks its result, printing how long it took if print is set
+	auto check = [&](const std::string& name, const std::string& equation, int expected) {
+		const auto start = std::chrono::steady_clock::now();
+		const auto value = evaluator.evaluate(equation);
+		const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+
+		if (value != expected) {
+			std::cout << "Incorrect stress test result: " << name << " is " << value << " which does not equal " << expected << std::endl;
+		}
+
+		if (print) {
+			std::cout << name << ": " << equation.size() << " characters in " << time.count() << "ms" << std::endl;
+		}
+	};
+
+	// One million tokens
+	std::string sum = "1";
+
+	for (int i = 0; i < 500000; ++i) {
+		sum += "+1";
+	}
+
+	check("Sum", sum, 500001);
+
+	// One million consecutive operator tokens
+	check("Not", std::string(1000000, '!') + "0", 0);
+	std::string negate;
+
+	for (int i = 0; i < 500001; ++i) {
+		negate += "- ";
+	}
+
+	check("Negate", negate + "1", -1);
+
+	// 100k levels of nesting, alone and around operators
+	check("Nested", std::string(100000, '(') + "7" + std::string(100000, ')'), 7);
+
+	std::string nested_sum;
+
+	for (int i = 0; i < 100000; ++i) {
+		nested_sum += "1+(";
+	}
+
+	nested_sum += "1" + std::string(100000, ')');
+	check("Nested sum", nested_sum, 100001);
+}
+
+void parallel_tests(bool print) {
+	// Equations of widely varying lengths, some of which are ill formed
+	std::vector<std::string> equations;
+
+	for (int i = 0; i < 5000; ++i) {
+		std::string equation = std::to_string(i);
+
+		for (int j = 0; j < (i * 37) % 300; ++j) {
+			equation += " + (1 - 1)";
+		}
+
+		if (i % 11 == 0) { equation += " / 0"; }
+		if (i % 13 == 0) { equation += " +"; }
+
+		equations.push_back(equation);
+	}
+
+	const std::vector<std::string_view> views(equations.cbegin(), equations.cend());
+
+	for (size_t workers : {1, 3, 8}) {
+		InfixParser::ThreadPool pool{workers};
+		const auto results = InfixParser::evaluate_batch(views, pool);
+
+		// Results are in input order with errors reported per equation
+		for (size_t i = 0; i < equations.size(); ++i) {
+			const bool should_fail = (i % 11 == 0) || (i % 13 == 0);
+
+			if (results[i].ok() == should_fail || (results[i].ok() && results[i].value != static_cast<int>(i))) {
+				std::cout << "Incorrect parallel result with " << workers << " workers for equation " << i << std::endl;
+				break;
+			}
+		}
+
+		if (print) { std::cout << results[11].message(views[11]) << std::endl; }
+	}
+
+	// Exceptions thrown by a task are passed to the caller
+	InfixParser::ThreadPool pool{4};
+
+	try {
+		pool.run(100, 1, [](size_t, size_t begin, size_t) {
+			if (begin == 42) { throw InfixParser::EvaluationException{"Task failed."}; }
+		});
+
+		std::cout << "No exception thrown by thread pool task" << std::endl;
+	} catch (const InfixParser::EvaluationException&) {
+	}
+}
+
+void statistics_tests([[maybe_unused]] bool print) {
+	InfixParser::Evaluator evaluator;
+	evaluator.evaluate("(1 + 2) * 3 - -4");
+	evaluator.evaluate("0 && 1 / 0");
+	evaluator.try_evaluate("1 +");
+	evaluator.compile("min(a, 2) + b");
+
+	try {
+		evaluator.evaluate("2 % 0");
+	} catch (const InfixParser::EvaluationException&) {
+	}
+
+	auto stats = evaluator.statistics();
+
+#if defined(INFIXPARSER_STATS)
+	using Operator = InfixParser::Operator;
+
+	// Operators skipped by && and folded while compiling are not applied
+	const bool applied = stats.applications(&Operator::ADD) == 1 && stats.applications(&Operator::MULTIPLY) == 1
+		&& stats.applications(&Operator::NEGATE) == 1 && stats.applications(&Operator::SUBTRACT) == 1
+		&& stats.applications(&Operator::AND) == 0 && stats.applications(&Operator::DIVIDE) == 0
+		&& stats.applications(&Operator::REMAINDER) == 1 && stats.applications(&Operator::MIN) == 0
+		&& stats.applications(&Operator::CHECKED_ADD) == stats.applications(&Operator::ADD);
+
+	if (stats.equations != 5 || stats.tokens != 28 || stats.exceptions != 1 || stats.max_operands != 3 || stats.max_operators != 2 || !applied) {
+		std::cout << "Incorrect statistics: " << stats.equations << " equations, " << stats.tokens << " tokens, " << stats.exceptions << " exceptions, "
+			<< stats.max_operands << " operands, " << stats.max_operators << " operators" << std::endl;
+	}
+
+	if (stats.converting.count() <= 0 || stats.applying.count() <= 0) {
+		std::cout << "Incorrect statistics timing" << std::endl;
+	}
+
+	// The evaluators of each thread are added up once they are done
+	InfixParser::ThreadPool pool{4};
+	std::vector<InfixParser::Evaluator> evaluators(pool.size());
+
+	pool.run(1000, 10, [&](size_t worker, size_t begin, size_t end) {
+		for (auto i = begin; i < end; ++i) {
+			evaluators[worker].try_evaluate(std::to_string(i) + " * 2 + 1");
+		}
+	});
+
+	InfixParser::Evaluator::Statistics total;
+
+	for (const auto& worker : evaluators) {
+		total += worker.statistics();
+	}
+
+	if (total.equations != 1000 || total.tokens != 5000 || total.applications(&Operator::MULTIPLY) != 1000 || total.max_operands != 2) {
+		std::cout << "Incorrect aggregated statistics: " << total.equations << " equations" << std::endl;
+	}
+
+	if (print) {
+		std::cout << total.equations << " equations, " << total.tokens << " tokens, converting " << total.converting.count() << "ns, applying "
+			<< total.applying.count() << "ns" << std::endl;
+	}
+
+	evaluator.reset_statistics();
+	stats = evaluator.statistics();
+#endif
+
+	// Without INFIXPARSER_STATS nothing is counted
+	const bool none_applied = std::all_of(stats.applied.cbegin(), stats.applied.cend(), [](uint64_t count) { return count == 0; });
+
+	if (stats.equations != 0 || stats.tokens != 0 || !none_applied || stats.converting.count() != 0) {
+		std::cout << "Statistics were not reset" << std::endl;
+	}
+}
+
 void run_tests(bool print) {
 	equation_tests();
 	equation_tests_mixed();
 	equation_throws_tests(print);
+	try_evaluate_tests(print);
+	compiled_tests(print);
+	variable_tests(print);
+	optimize_tests(print);
+	short_circuit_tests(print);
+	function_tests(print);
+	arithmetic_tests(print);
+	numeric_type_tests();
+	constant_tests(print);
+	batch_tests(print);
+	filter_tests(print);
+	expression_set_tests(print);
+	pack_tests(print);
+	cache_tests(print);
+	formula_graph_tests(print);
+	allocation_tests(print);
+	registry_tests(print);
+	lexer_tests(print);
+	stress_tests(print);
+	parallel_tests(print);
+	statistics_tests(print);
 }
 
-int main() {
-	// Change this to true to print the error messages from the tests
-	run_tests(false);
+/**
+ * @brief Buffers text and writes it to stdout in large blocks.
+ */
+class Output {
+	public:
+		~Output() {
+			flush();
+		}
 
-	// Example usage
-	try {
-		std::string equation = "(2 + 3) * 5";
-		InfixParser::Evaluator evaluator;
+		void write(std::string_view text) {
+			buffer.append(text);
 
-		auto result = evaluator.evaluate(equation);
+			if (buffer.size() >= (1 << 16)) {
+				flush();
+			}
+		}
 
-		std::cout << equation << " = " << result << "\n";
-	} catch (const InfixParser::EvaluationException& except) {
-		// Print out any errors
-		std::cout << except.what() << std::endl;
-		throw except;
+		void write(int value) {
+			char digits[16];
+			auto result = std::to_chars(digits, digits + sizeof(digits), value);
+			write(std::string_view{digits, static_cast<size_t>(result.ptr - digits)});
+		}
+
+		void write_error(std::string_view message) {
+			// Only the first line of an annotated message fits on an output line
+			write("error: ");
+			write(message.substr(0, message.find('\n')));
+			write("\n");
+		}
+
+		void flush() {
+			std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+			buffer.clear();
+		}
+
+	private:
+		std::string buffer;
+};
+
+/**
+ * @brief Writes the value or error of one evaluated line to @p output.
+ * @param[in] result The result of evaluating @p line.
+ * @param[in] line The line that was evaluated.
+ * @param[in,out] output The output to write the result to.
+ */
+void write_result(const InfixParser::EvaluationResult& result, std::string_view line, Output& output) {
+	if (result.ok()) {
+		output.write(result.value);
+		output.write("\n");
+	} else {
+		output.write_error(result.message(line));
+	}
+}
+
+/**
+ * @brief Evaluates each line in [@p begin, @p end) and writes one result per line to @p output.
+ * @param[in] begin The beginning of the lines.
+ * @param[in] end The end of the lines.
+ * @param[in] pool The thread pool to evaluate with. nullptr to evaluate on the calling thread.
+ * @param[in,out] output The output to write the results to.
+ */
+void evaluate_lines(const char* begin, const char* end, InfixParser::ThreadPool* pool, Output& output) {
+	static InfixParser::Evaluator evaluator;
+	std::vector<std::string_view> lines;
+
+	while (begin != end) {
+		// Split off a batch of lines
+		lines.clear();
+
+		while (begin != end && lines.size() < 4096) {
+			auto line_end = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+			auto next = line_end ? line_end + 1 : end;
+			line_end = line_end ? line_end : end;
+
+			// Accept Windows line endings
+			if (line_end != begin && line_end[-1] == '\r') { --line_end; }
+
+			lines.emplace_back(begin, line_end - begin);
+			begin = next;
+		}
+
+		// Evaluate the batch
+		if (pool) {
+			const auto results = InfixParser::evaluate_batch(lines, *pool);
+
+			for (size_t i = 0; i < results.size(); ++i) {
+				write_result(results[i], lines[i], output);
+			}
+		} else {
+			for (const auto& line : lines) {
+				write_result(evaluator.try_evaluate(line), line, output);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Evaluates each line read from @p input and writes one result per line to @p output.
+ * @param[in] input The file to read lines from.
+ * @param[in] pool The thread pool to evaluate with. nullptr to evaluate on the calling thread.
+ * @param[in,out] output The output to write the results to.
+ */
+void evaluate_stream(std::FILE* input, InfixParser::ThreadPool* pool, Output& output) {
+	std::vector<char> buffer(1 << 20);
+	size_t filled = 0;
+
+	while (true) {
+		// Grow the buffer if a single line does not fit
+		if (filled == buffer.size()) {
+			buffer.resize(buffer.size() * 2);
+		}
+
+		const auto read = std::fread(buffer.data() + filled, 1, buffer.size() - filled, input);
+		filled += read;
+
+		// Evaluate whatever is left at the end of the input
+		if (read == 0) {
+			evaluate_lines(buffer.data(), buffer.data() + filled, pool, output);
+			return;
+		}
+
+		// Evaluate every complete line and keep the partial line for the next read
+		auto complete = filled;
+
+		while (complete != 0 && buffer[complete - 1] != '\n') {
+			--complete;
+		}
+
+		if (complete != 0) {
+			evaluate_lines(buffer.data(), buffer.data() + complete, pool, output);
+			std::memmove(buffer.data(), buffer.data() + complete, filled - complete);
+			filled -= complete;
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const char* path = nullptr;
+	size_t threads = 1;
+	bool test = false;
+	bool verbose = false;
+
+	// Read the arguments
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view argument = argv[i];
+
+		if (argument == "--test") {
+			test = true;
+		} else if (argument == "--verbose") {
+			verbose = true;
+		} else if (argument == "--threads" && i + 1 < argc) {
+			threads = std::strtoul(argv[++i], nullptr, 10);
+			threads = threads ? threads : std::thread::hardware_concurrency();
+		} else if (argument == "--help" || argument == "-h" || (!argument.empty() && argument[0] == '-' && argument != "-") || path) {
+			std::cout
+				<< "Usage: " << argv[0] << " [--threads N] [file]\n"
+				<< "       " << argv[0] << " --test [--verbose]\n\n"
+				<< "Evaluates one equation per line of file, or of stdin if no file or \"-\" is given,\n"
+				<< "and writes one result or \"error: <message>\" per line to stdout.\n\n"
+				<< "  --threads N  Evaluate using N threads. 0 uses one per hardware thread. Default 1.\n"
+				<< "  --test       Run the built-in tests instead.\n"
+				<< "  --verbose    Print the error messages from the built-in tests.\n";
+			return argument == "--help" || argument == "-h" ? 0 : 2;
+		} else {
+			path = argv[i];
+		}
+	}
+
+	if (test) {
+		run_tests(verbose);
+		std::cout << "Done." << std::endl;
+		return 0;
+	}
+
+	// Evaluate the input
+	std::unique_ptr<InfixParser::ThreadPool> pool;
+
+	if (threads > 1) {
+		pool = std::make_unique<InfixParser::ThreadPool>(threads);
+	}
+
+	Output output;
+
+	try {
+		if (path && std::string_view{path} != "-") {
+			InfixParser::MappedFile file{path};
+			evaluate_lines(file.data(), file.data() + file.size(), pool.get(), output);
+		} else {
+			evaluate_stream(stdin, pool.get(), output);
+		}
+	} catch (const InfixParser::MappedFileException& except) {
+		std::cerr << except.what() << std::endl;
+		return 2;
 	}
 
-	std::cout << "Done." << std::endl;
-	getchar();
 	return 0;
-}
\ No newline at end of file
+}